@@ -2,15 +2,19 @@
 
 #include <iomanip>
 #include <stdlib.h>
+#include <vector>
 
 #include "./StaticSchedule.h"
 
 #include <inet/common/ModuleAccess.h>
 #include <inet/linklayer/common/InterfaceTag_m.h>
 #include <inet/linklayer/common/MacAddressTag_m.h>
+#include <inet/linklayer/common/UserPriorityTag_m.h>
+#include <inet/networklayer/common/DscpTag_m.h>
 #include <inet/common/ProtocolTag_m.h>
 #include <inet/common/ProtocolGroup.h>
 #include <inet/common/packet/chunk/ByteCountChunk.h>
+#include <inet/common/packet/chunk/BytesChunk.h>
 #include <inet/physicallayer/base/packetlevel/FlatRadioBase.h>
 #include <inet/physicallayer/common/packetlevel/SignalTag_m.h>
 #include <inet/physicallayer/contract/packetlevel/IRadio.h>
@@ -20,6 +24,7 @@
 #include "openDSME/dsmeAdaptionLayer/scheduling/PIDScheduling.h"
 #include "openDSME/dsmeAdaptionLayer/scheduling/TPS.h"
 #include "openDSME/dsmeAdaptionLayer/scheduling/StaticScheduling.h"
+#include "openDSME/dsmeAdaptionLayer/scheduling/BacklogScheduling.h"
 #include "openDSME/mac_services/pib/dsme_phy_constants.h"
 
 // coverity[+kill]
@@ -43,6 +48,10 @@ simsignal_t DSMEPlatform::ackSentDown;
 simsignal_t DSMEPlatform::uncorruptedFrameReceived;
 simsignal_t DSMEPlatform::corruptedFrameReceived;
 simsignal_t DSMEPlatform::gtsChange;
+simsignal_t DSMEPlatform::gtsFramesPerSlot;
+simsignal_t DSMEPlatform::queueLength[QueueId::QUEUE_COUNT];
+simsignal_t DSMEPlatform::queueHighWaterMark[QueueId::QUEUE_COUNT];
+simsignal_t DSMEPlatform::timerLateness[EventTimers::TIMER_COUNT];
 
 static void translateMacAddress(MacAddress& from, IEEE802154MacAddress& to) {
     // TODO only handles short address
@@ -84,6 +93,14 @@ static std::string getErrorInfo(inet::Packet* packet) {
     return ss.str();
 }
 
+static uint16_t getCapacityParameter(cModule* module, const char* name) {
+    int capacity = module->par(name);
+    if(capacity < 1 || capacity > UINT16_MAX) {
+        throw cRuntimeError("%s has to be between 1 and %d", name, UINT16_MAX);
+    }
+    return capacity;
+}
+
 DSMEPlatform::DSMEPlatform()
     : phy_pib(),
       mac_pib(phy_pib),
@@ -100,6 +117,18 @@ DSMEPlatform::DSMEPlatform()
     uncorruptedFrameReceived = registerSignal("uncorruptedFrameReceived");
     corruptedFrameReceived = registerSignal("corruptedFrameReceived");
     gtsChange = registerSignal("GTSChange");
+    timerLateness[NEXT_PRE_SLOT] = registerSignal("preSlotTimerLateness");
+    timerLateness[NEXT_SLOT] = registerSignal("slotTimerLateness");
+    timerLateness[CSMA_TIMER] = registerSignal("csmaTimerLateness");
+    timerLateness[ACK_TIMER] = registerSignal("ackTimerLateness");
+    timerLateness[GTS_FRAME_TIMER] = registerSignal("gtsFrameTimerLateness");
+    gtsFramesPerSlot = registerSignal("gtsFramesPerSlot");
+    queueLength[CAP_QUEUE] = registerSignal("capQueueLength");
+    queueLength[GTS_QUEUE] = registerSignal("gtsQueueLength");
+    queueLength[RETRY_BUFFER] = registerSignal("retryBufferLength");
+    queueHighWaterMark[CAP_QUEUE] = registerSignal("capQueueHighWaterMark");
+    queueHighWaterMark[GTS_QUEUE] = registerSignal("gtsQueueHighWaterMark");
+    queueHighWaterMark[RETRY_BUFFER] = registerSignal("retryBufferHighWaterMark");
 }
 
 DSMEPlatform::~DSMEPlatform() {
@@ -109,6 +138,9 @@ DSMEPlatform::~DSMEPlatform() {
     cancelAndDelete(ccaTimer);
     cancelAndDelete(cfpTimer);
     cancelAndDelete(timer);
+    for(uint8_t i = 0; i < EventTimers::TIMER_COUNT; i++) {
+        cancelAndDelete(nativeTimers[i]);
+    }
 }
 
 /****** INET ******/
@@ -165,12 +197,39 @@ void DSMEPlatform::initialize(int stage) {
         else if(!strcmp(schedulingSelection, "STATIC")) {
             scheduling = new StaticScheduling(this->dsmeAdaptionLayer); 
         } 
+        else if(!strcmp(schedulingSelection, "BACKLOG")) {
+            scheduling = new BacklogScheduling(this->dsmeAdaptionLayer);
+        }
         else {
             ASSERT(false);
         }
 
         uint8_t scanDuration = par("scanDuration").intValue();
 
+        /* the queues are sized by the DSME and adaption layer during their initialization */
+        this->mac_pib.macMaxNeighbors = getCapacityParameter(this, "maxNeighbors");
+        this->mac_pib.macCAPQueueSize = getCapacityParameter(this, "capQueueSize");
+        this->mac_pib.macGTSQueueSize = getCapacityParameter(this, "gtsQueueSize");
+        this->mac_pib.macUpperLayerQueueSize = getCapacityParameter(this, "upperLayerQueueSize");
+        this->messagePoolSize = getCapacityParameter(this, "messagePoolSize");
+        this->mac_pib.macGTSQueueEDF = par("gtsQueueEDF");
+        this->gtsQueueDeadline = par("gtsQueueDeadline");
+        this->mac_pib.macGTSQueueGuaranteed = par("gtsQueueGuaranteed");
+        this->mac_pib.macMultipleFramesPerGTS = par("multipleFramesPerGTS");
+        int maxAggregateSize = par("maxAggregateSize");
+        if(maxAggregateSize < 0 || maxAggregateSize > aMaxPHYPacketSize) {
+            throw cRuntimeError("maxAggregateSize has to be between 0 and %d bytes", aMaxPHYPacketSize);
+        }
+        this->mac_pib.macMaxAggregateSize = maxAggregateSize;
+        const char* dropPolicy = par("gtsQueueDropPolicy");
+        if(!strcmp(dropPolicy, "headDrop")) {
+            this->mac_pib.macGTSQueueDropPolicy = HEAD_DROP;
+        } else if(!strcmp(dropPolicy, "sojournTime")) {
+            this->mac_pib.macGTSQueueDropPolicy = SOJOURN_TIME;
+        } else {
+            this->mac_pib.macGTSQueueDropPolicy = TAIL_DROP;
+        }
+
         this->dsmeAdaptionLayer.initialize(scanChannels,scanDuration,scheduling);
 
         /* Initialize Address */
@@ -198,10 +257,35 @@ void DSMEPlatform::initialize(int stage) {
         radio = check_and_cast<IRadio*>(radioModule);
 
         symbolDuration = SimTime(16, SIMTIME_US);
+        symbolDurationRaw = symbolDuration.raw();
+        this->mac_pib.macGTSQueueSojournTarget = SimTime(par("gtsQueueSojournTarget").doubleValue()).raw() / symbolDurationRaw;
+        this->mac_pib.macGTSQueueSojournInterval = SimTime(par("gtsQueueSojournInterval").doubleValue()).raw() / symbolDurationRaw;
+        this->mac_pib.macAggregationDelayBudget = SimTime(par("aggregationDelayBudget").doubleValue()).raw() / symbolDurationRaw;
+        this->mac_pib.macRetryBufferBackoff = SimTime(par("retryBufferBackoff").doubleValue()).raw() / symbolDurationRaw;
+        int maxBackoffExponent = par("retryBufferMaxBackoffExponent");
+        if(maxBackoffExponent < 0 || maxBackoffExponent > 15) {
+            throw cRuntimeError("retryBufferMaxBackoffExponent has to be between 0 and 15");
+        }
+        this->mac_pib.macRetryBufferMaxBackoffExponent = maxBackoffExponent;
+        this->mac_pib.macNeighborIdleTimeout = SimTime(par("neighborIdleTimeout").doubleValue()).raw() / symbolDurationRaw;
+        this->mac_pib.macRetryBufferMaxAge = SimTime(par("retryBufferMaxAge").doubleValue()).raw() / symbolDurationRaw;
         timer = new cMessage();
         cfpTimer = new cMessage();
         ccaTimer = new cMessage();
 
+        const char* timerBackend = par("timerBackend");
+        if(!strcmp(timerBackend, "native")) {
+            useNativeTimers = true;
+            for(uint8_t i = 0; i < EventTimers::TIMER_COUNT; i++) {
+                nativeTimers[i] = new cMessage("nativeTimer", i);
+                // events due at the same time are handled in the same order as by the TimerMultiplexer
+                nativeTimers[i]->setSchedulingPriority(i);
+            }
+        }
+        else if(strcmp(timerBackend, "multiplexer")) {
+            throw cRuntimeError("Unknown timer backend \"%s\"", timerBackend);
+        }
+
         // check parameters for consistency
         // aTurnaroundTimeSymbols should match (be equal or bigger) the RX to TX
         // switching time of the radio
@@ -228,6 +312,8 @@ void DSMEPlatform::initialize(int stage) {
         this->mac_pib.macBeaconOrder = par("beaconOrder");
         this->mac_pib.macSuperframeOrder = par("superframeOrder");
         this->mac_pib.macMultiSuperframeOrder = par("multiSuperframeOrder");
+        this->mac_pib.macTransactionPersistenceTime = par("macTransactionPersistenceTime");
+        this->mac_pib.helper.update();
 
         this->mac_pib.macMinBE = par("macMinBE");
         this->mac_pib.macMaxBE = par("macMaxBE");
@@ -251,6 +337,23 @@ void DSMEPlatform::initialize(int stage) {
 
         this->dsme->initialize(this);
 
+        // the backlog scheduling needs the symbol duration and the final GTS expiration time
+        if(!strcmp(schedulingSelection, "BACKLOG")) {
+            BacklogScheduling* backlog = static_cast<BacklogScheduling*>(scheduling);
+            double maxQueueingDelay = par("backlogMaxQueueingDelay").doubleValue();
+            if(maxQueueingDelay < 0) {
+                throw cRuntimeError("backlogMaxQueueingDelay must not be negative");
+            }
+            backlog->setMaxQueueingDelay(SimTime(maxQueueingDelay).raw() / symbolDurationRaw);
+
+            int maxSlotsPerRequest = par("backlogMaxSlotsPerRequest");
+            if(maxSlotsPerRequest < 1 || maxSlotsPerRequest > UINT8_MAX) {
+                throw cRuntimeError("backlogMaxSlotsPerRequest has to be between 1 and %d", UINT8_MAX);
+            }
+            backlog->setMaxSlotsPerRequest(maxSlotsPerRequest);
+            backlog->setMinFreshness(this->mac_pib.macDSMEGTSExpirationTime);
+        }
+
         // static schedules need to be initialized after dsmeLayer
         if(!strcmp(schedulingSelection, "STATIC")) {
             cXMLElement *xmlFile = par("staticSchedule");
@@ -278,7 +381,50 @@ void DSMEPlatform::finish() {
     recordScalar("numUpperPacketsForCAP", dsme->getMessageDispatcher().getNumUpperPacketsForCAP());
     recordScalar("numUpperPacketsForGTS", dsme->getMessageDispatcher().getNumUpperPacketsForGTS());
     recordScalar("numUpperPacketsDroppedFullQueue", dsme->getMessageDispatcher().getNumUpperPacketsDroppedFullQueue());
+    recordScalar("numUpperPacketsDroppedSojournTime", dsme->getMessageDispatcher().getNumUpperPacketsDroppedSojournTime());
+    recordScalar("numUpperPacketsDroppedExpired", dsme->getMessageDispatcher().getNumUpperPacketsDroppedExpired());
+    recordScalar("numEvictedNeighbors", dsme->getMessageDispatcher().getNumEvictedNeighbors());
+    recordScalar("numRetryBufferRetries", dsmeAdaptionLayer.getMessageHelper().getNumRetries());
+    recordScalar("numRetryBufferDroppedFull", dsmeAdaptionLayer.getMessageHelper().getNumRetryBufferDroppedFull());
+    recordScalar("numRetryBufferDroppedMaxAge", dsmeAdaptionLayer.getMessageHelper().getNumRetryBufferDroppedMaxAge());
     recordScalar("macChannelOffset", dsme->getMAC_PIB().macChannelOffset);
+
+    long numTxAggregates = dsme->getMessageDispatcher().getNumTxAggregates();
+    long numAggregatedMessages = dsme->getMessageDispatcher().getNumAggregatedMessages();
+    recordScalar("numTxAggregates", numTxAggregates);
+    recordScalar("numTxAggregatedPackets", numAggregatedMessages);
+    recordScalar("txAggregationRatio", numTxAggregates > 0 ? (double)numAggregatedMessages / numTxAggregates : 0);
+    recordScalar("numRxAggregates", numRxAggregates);
+    recordScalar("numRxAggregatedPackets", numRxAggregatedPackets);
+
+    /* the fixed-size state of the layers plus the tables and queues allocated at initialization */
+    uint32_t macMemory = sizeof(DSMELayer) + sizeof(DSMEAdaptionLayer) + sizeof(MAC_PIB) + sizeof(PHY_PIB);
+    macMemory += mac_pib.macDSMEACT.getAllocatedMemory() + mac_pib.macDSMESAB.getAllocatedMemory();
+    macMemory += dsme->getMessageDispatcher().getNeighborQueue().getAllocatedMemory();
+    macMemory += scheduling->getAllocatedMemory();
+    macMemory += mac_pib.macCAPQueueSize * sizeof(IDSMEMessage*);
+    macMemory += mac_pib.macGTSQueueSize * sizeof(IDSMEMessage*); // expired messages collected by the MessageDispatcher
+    macMemory += mac_pib.macUpperLayerQueueSize * sizeof(DSMEAdaptionLayerBufferEntry);
+    recordScalar("macMemory", macMemory, "B");
+
+#ifdef DSME_PROFILING
+    for(uint8_t i = PROFILE_NONE + 1; i < PROFILE_SUBSYSTEM_COUNT; i++) {
+        ProfilerSubsystem subsystem = static_cast<ProfilerSubsystem>(i);
+        std::string name = DSMEProfiler::getName(subsystem);
+        recordScalar(("profile" + name + "Calls").c_str(), dsme->getProfiler().getCalls(subsystem));
+        recordScalar(("profile" + name + "Cycles").c_str(), dsme->getProfiler().getCycles(subsystem));
+    }
+#endif
+}
+
+void DSMEPlatform::handleMessage(cMessage* msg) {
+    /* The simulation time does not change during an event, so the symbol counter is computed only once */
+    cachedSymbolCounter = computeSymbolCounter();
+    cachedSymbolCounterValid = true;
+
+    MacProtocolBase::handleMessage(msg);
+
+    cachedSymbolCounterValid = false;
 }
 
 void DSMEPlatform::handleLowerPacket(inet::Packet* packet) {
@@ -351,13 +497,40 @@ void DSMEPlatform::handleUpperPacket(inet::Packet* packet) {
 
     translateMacAddress(destinationAddress, message->getHeader().getDestAddr());
 
+    message->priorityClass = getPriorityClass(packet);
+    if(packet->hasPar("deadline")) {
+        /* '-> the packet is of no use after its deadline */
+        message->expirySymbolCounter = SimTime(packet->par("deadline").doubleValue()).raw() / symbolDurationRaw;
+        message->hasExpiry = true;
+    }
+    if(this->mac_pib.macGTSQueueEDF) {
+        SimTime deadline = packet->hasPar("deadline") ? SimTime(packet->par("deadline").doubleValue()) : simTime() + gtsQueueDeadline;
+        message->deadline = deadline.raw() / symbolDurationRaw;
+    }
+
     message->firstTry = true;
     this->dsmeAdaptionLayer.sendMessage(message);
 }
 
+uint8_t DSMEPlatform::getPriorityClass(inet::Packet* packet) {
+    /* user priorities in ascending order of urgency are 1 (background), 2, 0 (best effort), 3, ..., 7 */
+    static const uint8_t userPriorityRank[8] = {2, 0, 1, 3, 4, 5, 6, 7};
+
+    uint8_t rank = 0;
+    if(auto* tag = packet->findTag<inet::UserPriorityReq>()) {
+        rank = userPriorityRank[tag->getUserPriority() & 0x7];
+    } else if(auto* tag = packet->findTag<inet::DscpReq>()) {
+        /* class selector, i.e. the former IP precedence */
+        rank = (tag->getDifferentiatedServicesCodePoint() >> 3) & 0x7;
+    }
+    return rank * NUM_PRIORITY_CLASSES / 8;
+}
+
 void DSMEPlatform::handleSelfMessage(cMessage* msg) {
     if(msg == timer) {
         dsme->getEventDispatcher().timerInterrupt();
+    } else if(useNativeTimers && msg->getKind() >= 0 && msg->getKind() < EventTimers::TIMER_COUNT && msg == nativeTimers[msg->getKind()]) {
+        dsme->getEventDispatcher().nativeTimerInterrupt(msg->getKind());
     } else if(msg == ccaTimer) {
         bool isIdle = (radio->getReceptionState() == IRadio::RECEPTION_STATE_IDLE) && channelInactive;
         LOG_DEBUG("CCA isIdle " << isIdle);
@@ -580,7 +753,7 @@ void DSMEPlatform::handleReceivedMessageFromAckLayer(IDSMEMessage* message) {
 
 DSMEMessage* DSMEPlatform::getEmptyMessage() {
     messagesInUse++;
-    DSME_ASSERT(messagesInUse <= MSG_POOL_SIZE); // TODO should return nullptr (and check everywhere!!)
+    DSME_ASSERT(messagesInUse <= messagePoolSize); // TODO should return nullptr (and check everywhere!!)
     auto msg = new DSMEMessage();
     msg->receivedViaMCPS = false;
     signalNewMsg(msg);
@@ -589,7 +762,7 @@ DSMEMessage* DSMEPlatform::getEmptyMessage() {
 
 DSMEMessage* DSMEPlatform::getLoadedMessage(inet::Packet* packet) {
     messagesInUse++;
-    DSME_ASSERT(messagesInUse <= MSG_POOL_SIZE); // TODO
+    DSME_ASSERT(messagesInUse <= messagePoolSize); // TODO
     auto msg = new DSMEMessage(packet);
     msg->receivedViaMCPS = false;
     signalNewMsg(msg);
@@ -611,7 +784,7 @@ void DSMEPlatform::releaseMessage(IDSMEMessage* msg) {
 }
 
 void DSMEPlatform::startTimer(uint32_t symbolCounterValue) {
-    SimTime time = symbolCounterValue * symbolDuration;
+    SimTime time = SimTime::fromRaw(symbolCounterValue * symbolDurationRaw);
     if(timer->isScheduled()) {
         cancelEvent(timer);
     }
@@ -621,7 +794,38 @@ void DSMEPlatform::startTimer(uint32_t symbolCounterValue) {
 }
 
 uint32_t DSMEPlatform::getSymbolCounter() {
-    return simTime() / symbolDuration;
+    if(cachedSymbolCounterValid) {
+        return cachedSymbolCounter;
+    }
+    /* '-> called from outside of handleMessage, e.g. via receiveSignal */
+    return computeSymbolCounter();
+}
+
+uint32_t DSMEPlatform::computeSymbolCounter() const {
+    return simTime().raw() / symbolDurationRaw;
+}
+
+bool DSMEPlatform::hasNativeTimers() {
+    return useNativeTimers;
+}
+
+void DSMEPlatform::startNativeTimer(uint8_t timer, uint32_t symbolCounterValue) {
+    cMessage* msg = nativeTimers[timer];
+    SimTime time = SimTime::fromRaw(symbolCounterValue * symbolDurationRaw);
+    if(msg->isScheduled()) {
+        cancelEvent(msg);
+    }
+    if(time < simTime()) {
+        // the lateness is reported to the DSME layer when handled
+        time = simTime();
+    }
+    scheduleAt(time, msg);
+}
+
+void DSMEPlatform::stopNativeTimer(uint8_t timer) {
+    if(nativeTimers[timer] != nullptr && nativeTimers[timer]->isScheduled()) {
+        cancelEvent(nativeTimers[timer]);
+    }
 }
 
 uint16_t DSMEPlatform::getRandom() {
@@ -667,11 +871,35 @@ void DSMEPlatform::handleIndicationFromMCPS(IDSMEMessage* msg) {
 
     inet::MacAddress address;
     translateMacAddress(dsmeMessage->getHeader().getSrcAddr(), address);
-    packet->addTagIfAbsent<MacAddressInd>()->setSrcAddress(address);
-    packet->addTagIfAbsent<InterfaceInd>()->setInterfaceId(interfaceEntry->getInterfaceId());
 
     releaseMessage(msg);
 
+    if(packet->hasPar("aggregate")) {
+        /* '-> split into the packets packed by createAggregate */
+        uint8_t count = packet->popAtFront<inet::BytesChunk>(inet::B(1))->getByte(0);
+        auto lengths = packet->popAtFront<inet::BytesChunk>(inet::B(count));
+
+        numRxAggregates++;
+        numRxAggregatedPackets += count;
+
+        for(uint8_t i = 0; i < count; i++) {
+            auto subPacket = new inet::Packet(packet->getName(), packet->popAtFront(inet::B(lengths->getByte(i))));
+            if(packet->hasPar("networkProtocol")) {
+                subPacket->addPar("networkProtocol").setLongValue(packet->par("networkProtocol").longValue());
+            }
+            sendUpIndication(subPacket, address);
+        }
+        delete packet;
+        return;
+    }
+
+    sendUpIndication(packet, address);
+}
+
+void DSMEPlatform::sendUpIndication(inet::Packet* packet, const inet::MacAddress& source) {
+    packet->addTagIfAbsent<MacAddressInd>()->setSrcAddress(source);
+    packet->addTagIfAbsent<InterfaceInd>()->setInterfaceId(interfaceEntry->getInterfaceId());
+
     if (packet->hasPar("networkProtocol")) {
         /* Reattach protocol information from par() */
         auto protocolId = packet->par("networkProtocol").longValue();
@@ -683,6 +911,61 @@ void DSMEPlatform::handleIndicationFromMCPS(IDSMEMessage* msg) {
     sendUp(packet);
 }
 
+IDSMEMessage* DSMEPlatform::createAggregate(IDSMEMessage* const* candidates, uint8_t numCandidates, uint8_t maxBytes, uint8_t& numAggregated) {
+    numAggregated = 0;
+
+    DSMEMessage* first = check_and_cast<DSMEMessage*>(candidates[0]);
+    long protocolId = first->packet->hasPar("networkProtocol") ? first->packet->par("networkProtocol").longValue() : -1;
+
+    /* MAC header, FCS and the sub-frame header, which is the number of packets followed by one length byte per packet */
+    uint16_t bytes = first->getHeader().getSerializationLength() + 2 + 1;
+    uint8_t count = 0;
+    for(; count < numCandidates; count++) {
+        DSMEMessage* candidate = check_and_cast<DSMEMessage*>(candidates[count]);
+        int64_t length = candidate->packet->getByteLength();
+        if(length == 0 || length > UINT8_MAX || bytes + 1 + length > maxBytes) {
+            break;
+        }
+
+        /* the receiver restores the protocol of the aggregate for all packets */
+        long candidateProtocolId = candidate->packet->hasPar("networkProtocol") ? candidate->packet->par("networkProtocol").longValue() : -1;
+        if(candidateProtocolId != protocolId) {
+            break;
+        }
+#if (ENABLE_SECURITY_ALL == 1)
+        if(candidate->getPayload().getSerializationLength() > 0) {
+            break;
+        }
+#endif
+        bytes += 1 + length;
+    }
+
+    if(count < 2) {
+        return nullptr;
+    }
+
+    std::vector<uint8_t> header(1 + count);
+    header[0] = count;
+    auto packet = new inet::Packet("DSMEAggregate");
+    for(uint8_t i = 0; i < count; i++) {
+        DSMEMessage* candidate = check_and_cast<DSMEMessage*>(candidates[i]);
+        header[1 + i] = candidate->packet->getByteLength();
+        packet->insertAtBack(candidate->packet->peekAll());
+    }
+    packet->insertAtFront(inet::makeShared<inet::BytesChunk>(header));
+    packet->addPar("aggregate").setBoolValue(true);
+    if(protocolId >= 0) {
+        packet->addPar("networkProtocol").setLongValue(protocolId);
+    }
+
+    DSMEMessage* aggregate = getLoadedMessage(packet);
+    aggregate->getHeader() = first->getHeader();
+    aggregate->priorityClass = first->priorityClass;
+
+    numAggregated = count;
+    return aggregate;
+}
+
 void DSMEPlatform::handleConfirmFromMCPS(IDSMEMessage* msg, DataStatus::Data_Status status) {
     releaseMessage(msg);
 }
@@ -867,4 +1150,18 @@ void DSMEPlatform::signalGTSChange(bool deallocation, IEEE802154MacAddress count
     emit(gtsChange, deallocation?-1:1);
 }
 
+void DSMEPlatform::signalTimerLateness(uint8_t timer, int32_t lateness) {
+    emit(timerLateness[timer], (long)lateness);
+}
+
+void DSMEPlatform::signalGTSFramesPerSlot(uint8_t numFrames) {
+    emit(gtsFramesPerSlot, (long)numFrames);
+}
+
+void DSMEPlatform::signalQueueOccupancy(QueueId queue, uint16_t size, uint16_t highWaterMark) {
+    DSME_ASSERT(queue < QueueId::QUEUE_COUNT);
+    emit(queueLength[queue], (long)size);
+    emit(queueHighWaterMark[queue], (long)highWaterMark);
+}
+
 }
@@ -55,6 +55,7 @@
 #include "DSMEMessage.h"
 #include "dsme_settings.h"
 #include "openDSME/dsmeAdaptionLayer/DSMEAdaptionLayer.h"
+#include "openDSME/dsmeLayer/DSMEEventDispatcher.h"
 #include "openDSME/helper/DSMEDelegate.h"
 #include "openDSME/interfaces/IDSMEPlatform.h"
 #include "openDSME/mac_services/dataStructures/IEEE802154MacAddress.h"
@@ -91,6 +92,9 @@ public:
     /** @brief Delete all dynamically allocated objects of the module*/
     virtual void finish() override;
 
+    /** @brief Caches the symbol counter for the duration of a single event */
+    virtual void handleMessage(omnetpp::cMessage*) override;
+
     /** @brief Handle messages from lower layer */
     virtual void handleLowerPacket(inet::Packet*) override;
 
@@ -138,6 +142,12 @@ public:
 
     virtual uint32_t getSymbolCounter() override;
 
+    virtual bool hasNativeTimers() override;
+
+    virtual void startNativeTimer(uint8_t timer, uint32_t symbolCounterValue) override;
+
+    virtual void stopNativeTimer(uint8_t timer) override;
+
     virtual uint16_t getRandom() override;
 
     virtual void updateVisual() override;
@@ -146,12 +156,24 @@ public:
 
     virtual uint8_t getMinCoordinatorLQI() override;
 
+    virtual void signalTimerLateness(uint8_t timer, int32_t lateness) override;
+
+    virtual void signalGTSFramesPerSlot(uint8_t numFrames) override;
+
+    virtual void signalQueueOccupancy(QueueId queue, uint16_t size, uint16_t highWaterMark) override;
+
+    virtual IDSMEMessage* createAggregate(IDSMEMessage* const* candidates, uint8_t numCandidates, uint8_t maxBytes, uint8_t& numAggregated) override;
+
     virtual void signalGTSChange(bool deallocation, IEEE802154MacAddress counterpart) override;
 
 private:
     DSMEMessage* getLoadedMessage(inet::Packet*);
 
+    /** @brief maps the 802.1D user priority or DSCP of a packet to a GTS queue class */
+    uint8_t getPriorityClass(inet::Packet*);
+
     void handleIndicationFromMCPS(IDSMEMessage* msg);
+    void sendUpIndication(inet::Packet* packet, const inet::MacAddress& source);
     void handleConfirmFromMCPS(IDSMEMessage* msg, DataStatus::Data_Status status);
 
     bool send(inet::Packet*);
@@ -169,6 +191,14 @@ private:
     DSMEAdaptionLayer dsmeAdaptionLayer;
 
     uint16_t messagesInUse{0};
+    uint16_t messagePoolSize{MSG_POOL_SIZE};
+
+    /** @brief relative deadline of packets without a "deadline" par(), only used with EDF */
+    omnetpp::SimTime gtsQueueDeadline{};
+
+    /** @brief number of received aggregate frames and of the packets they contained */
+    long numRxAggregates{0};
+    long numRxAggregatedPackets{0};
     uint16_t msgId{0};
     receive_delegate_t receiveFromAckLayerDelegate{};
 
@@ -178,6 +208,10 @@ private:
     omnetpp::cMessage* timer{nullptr};
     omnetpp::cMessage* ccaTimer{nullptr};
     omnetpp::cMessage* cfpTimer{nullptr};
+
+    /** @brief one preallocated timer per event type if the native timer backend is selected */
+    bool useNativeTimers{false};
+    omnetpp::cMessage* nativeTimers[EventTimers::TIMER_COUNT]{};
     Delegate<void(bool)> txEndCallback{};
     inet::Packet* pendingTxPacket{nullptr};
     bool pendingSendRequest{false};
@@ -197,6 +231,15 @@ private:
     uint8_t minCoordinatorLQI{0};
     uint8_t currentChannel{0};
 
+    /** @brief symbolDuration in raw SimTime units, avoids the division of two SimTimes */
+    int64_t symbolDurationRaw{0};
+
+    /** @brief symbol counter of the event currently handled, valid only inside handleMessage */
+    uint32_t cachedSymbolCounter{0};
+    bool cachedSymbolCounterValid{false};
+
+    uint32_t computeSymbolCounter() const;
+
 public:
     omnetpp::SimTime symbolDuration;
 
@@ -208,6 +251,10 @@ public:
     static omnetpp::simsignal_t uncorruptedFrameReceived;
     static omnetpp::simsignal_t corruptedFrameReceived;
     static omnetpp::simsignal_t gtsChange;
+    static omnetpp::simsignal_t gtsFramesPerSlot;
+    static omnetpp::simsignal_t queueLength[QueueId::QUEUE_COUNT];
+    static omnetpp::simsignal_t queueHighWaterMark[QueueId::QUEUE_COUNT];
+    static omnetpp::simsignal_t timerLateness[EventTimers::TIMER_COUNT];
 
 public:
     IEEE802154MacAddress& getAddress() {
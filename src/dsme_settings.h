@@ -47,6 +47,12 @@
 
 #define STATISTICS_BEACONS
 
+/* Records the lateness of every handled timer event as OMNeT++ statistics */
+// #define STATISTICS_MONITOR_LATENESS
+
+/* Aggregates calls and CPU cycles per openDSME subsystem, recorded as scalars at the end of the simulation */
+// #define DSME_PROFILING
+
 namespace dsme {
 
 namespace const_redefines {
@@ -70,11 +76,15 @@ constexpr uint16_t MAX_OCCUPIED_SLOTS = MAX_SUPERFRAMES_PER_MULTI_SUPERFRAME * M
 
 constexpr uint8_t MAX_SAB_UNITS = 1;
 
+/* Defaults of the queue capacities, the DSMEPlatform overrides them with its NED parameters */
 constexpr uint16_t CAP_QUEUE_SIZE = 8;
 constexpr uint16_t TOTAL_GTS_QUEUE_SIZE = 30 - CAP_QUEUE_SIZE;
 constexpr uint16_t UPPER_LAYER_QUEUE_SIZE = 12;
 constexpr uint16_t MSG_POOL_SIZE = CAP_QUEUE_SIZE + TOTAL_GTS_QUEUE_SIZE + 2 * UPPER_LAYER_QUEUE_SIZE + 10;
 constexpr uint8_t ADDITIONAL_ACK_WAIT_DURATION = 0;
+
+constexpr uint8_t NUM_PRIORITY_CLASSES = 4; // separate GTS queues per neighbor, at most 8
+constexpr uint8_t MAX_AGGREGATED_MESSAGES = 8; // upper layer packets packed into one GTS frame
 }
 
 #endif
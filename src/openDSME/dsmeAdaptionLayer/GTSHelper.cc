@@ -64,6 +64,7 @@ GTSHelper::GTSHelper(DSMEAdaptionLayer& dsmeAdaptionLayer) : dsmeAdaptionLayer(d
 
 void GTSHelper::initialize(GTSScheduling* scheduling) {
     this->gtsScheduling = scheduling;
+    this->gtsScheduling->initialize(this->dsmeAdaptionLayer.getMAC_PIB().macMaxNeighbors);
 
     this->dsmeAdaptionLayer.getDSME().setStartOfCFPDelegate(DELEGATE(&GTSHelper::handleStartOfCFP, *this)); /* BAD cross-layer hack */
 
@@ -91,8 +92,14 @@ void GTSHelper::indicateReceivedMessage(uint16_t address) {
 }
 
 void GTSHelper::handleStartOfCFP() {
+    DSME_PROFILE(this->dsmeAdaptionLayer.getDSME().getProfiler(), PROFILE_SCHEDULING);
+
+    /* '-> resubmit the buffered messages whose back-off has passed */
+    this->dsmeAdaptionLayer.getMessageHelper().sendRetryBuffer();
+
     if(this->dsmeAdaptionLayer.getDSME().getCurrentSuperframe() == 0) {
         this->gtsScheduling->multisuperframeEvent();
+        this->dsmeAdaptionLayer.getMessageHelper().signalQueueOccupancy();
     }
 
     /* Check allocation at random superframe in multi-superframe */
@@ -105,6 +112,8 @@ void GTSHelper::handleStartOfCFP() {
 }
 
 void GTSHelper::checkAllocationForPacket(uint16_t address) {
+    DSME_PROFILE(this->dsmeAdaptionLayer.getDSME().getProfiler(), PROFILE_SCHEDULING);
+
     performSchedulingAction(this->gtsScheduling->getNextSchedulingAction(address));
     return;
 }
@@ -118,7 +127,7 @@ void GTSHelper::performSchedulingAction(GTSSchedulingDecision decision) {
     if(decision.managementType == ManagementType::ALLOCATION) {
         checkAndAllocateGTS(decision);
     } else if(decision.managementType == ManagementType::DEALLOCATION) {
-        checkAndDeallocateSingeleGTS(decision.deviceAddress);
+        checkAndDeallocateGTS(decision);
     } else {
         DSME_ASSERT(false);
     }
@@ -153,7 +162,11 @@ void GTSHelper::checkAndAllocateGTS(GTSSchedulingDecision decision) {
     params.managementType = ManagementType::ALLOCATION;
     params.direction = decision.direction;
     params.prioritizedChannelAccess = Priority::LOW;
+    /* '-> all slots of a request have to fit into the SAB sub-block of the preferred superframe */
     params.numSlot = decision.numSlot;
+    if(params.numSlot > this->dsmeAdaptionLayer.getMAC_PIB().helper.getNumGTSlots(preferredGTS.superframeID)) {
+        params.numSlot = this->dsmeAdaptionLayer.getMAC_PIB().helper.getNumGTSlots(preferredGTS.superframeID);
+    }
     params.preferredSuperframeId = preferredGTS.superframeID;
     params.preferredSlotId = preferredGTS.slotID;
 
@@ -161,48 +174,68 @@ void GTSHelper::checkAndAllocateGTS(GTSSchedulingDecision decision) {
     params.dsmeSabSpecification.setSubBlockIndex(preferredGTS.superframeID);
     macDSMESAB.getOccupiedSubBlock(params.dsmeSabSpecification, preferredGTS.superframeID);
 
-    LOG_INFO("ALLOCATING slot " << preferredGTS.slotID << " " << preferredGTS.superframeID << " " << (uint16_t)preferredGTS.channel << " with 0x" << HEXOUT
-                                << params.deviceAddress << DECOUT << ".");
+    LOG_INFO("ALLOCATING " << (uint16_t)params.numSlot << " slot(s) from " << preferredGTS.slotID << " " << preferredGTS.superframeID << " "
+                           << (uint16_t)preferredGTS.channel << " with 0x" << HEXOUT << params.deviceAddress << DECOUT << ".");
 
     /* mark all impossible slots that are in use in other channels, too */
-    for(DSMEAllocationCounterTable::iterator it = macDSMEACT.begin(); it != macDSMEACT.end(); ++it) {
-        if(it->getSuperframeID() == preferredGTS.superframeID) {
-            for(uint8_t channel = 0; channel < numChannels; channel++) {
-                params.dsmeSabSpecification.getSubBlock().set(it->getGTSlotID() * numChannels + channel, true);
-            }
-        }
+    uint16_t allocatedSlots = macDSMEACT.getAllocatedSlots(preferredGTS.superframeID);
+    while(allocatedSlots != 0) {
+        uint8_t slotID = __builtin_ctz(allocatedSlots);
+        allocatedSlots &= allocatedSlots - 1;
+        params.dsmeSabSpecification.getSubBlock().setBits(slotID * numChannels, numChannels, (1 << numChannels) - 1);
     }
 
     this->dsmeAdaptionLayer.getMLME_SAP().getDSME_GTS().request(params);
     return;
 }
 
-void GTSHelper::checkAndDeallocateSingeleGTS(uint16_t address) {
+void GTSHelper::checkAndDeallocateGTS(GTSSchedulingDecision decision) {
     DSMEAllocationCounterTable& act = this->dsmeAdaptionLayer.getMAC_PIB().macDSMEACT;
-    int16_t highestIdleCounter = -1;
-    DSMEAllocationCounterTable::iterator toDeallocate = act.end();
-    for(auto it = act.begin(); it != act.end(); ++it) {
-        if(it->getDirection() == Direction::TX && it->getAddress() == address) {
-            if(it->getState() == ACTState::VALID && it->getIdleCounter() > highestIdleCounter) {
-                highestIdleCounter = it->getIdleCounter();
+    const uint8_t numChannels = this->dsmeAdaptionLayer.getMAC_PIB().helper.getNumChannels();
+
+    DSMESABSpecification dsmeSABSpecification;
+    uint16_t superframeID = 0;
+    uint16_t selectedSlots = 0;
+    uint8_t numSelected = 0;
+
+    /* '-> a SAB sub-block only covers a single superframe, so the slots are taken from the superframe of the most idle one */
+    while(numSelected < decision.numSlot) {
+        int16_t highestIdleCounter = -1;
+        DSMEAllocationCounterTable::iterator toDeallocate = act.end();
+        for(auto it = act.begin(decision.deviceAddress, Direction::TX); it != act.end(); ++it) {
+            if(it->getState() != ACTState::VALID) {
+                continue;
+            }
+            if(numSelected > 0 && (it->getSuperframeID() != superframeID || (selectedSlots & (1 << it->getGTSlotID())))) {
+                continue;
+            }
+            if(act.getIdleCounter(it) > highestIdleCounter) {
+                highestIdleCounter = act.getIdleCounter(it);
                 toDeallocate = it;
             }
         }
-    }
 
-    if(toDeallocate != act.end()) {
+        if(toDeallocate == act.end()) {
+            break;
+        }
+
+        if(numSelected == 0) {
+            superframeID = toDeallocate->getSuperframeID();
+            dsmeSABSpecification.setSubBlockLengthBytes(this->dsmeAdaptionLayer.getMAC_PIB().helper.getSubBlockLengthBytes(superframeID));
+            dsmeSABSpecification.setSubBlockIndex(superframeID);
+            dsmeSABSpecification.getSubBlock().fill(false);
+        }
+
         LOG_INFO("DEALLOCATING slot " << toDeallocate->getSuperframeID() << "/" << toDeallocate->getGTSlotID() << " with 0x" << HEXOUT
                                       << toDeallocate->getAddress() << DECOUT);
 
-        DSMESABSpecification dsmeSABSpecification;
-        uint8_t subBlockLengthBytes = this->dsmeAdaptionLayer.getMAC_PIB().helper.getSubBlockLengthBytes(toDeallocate->getSuperframeID());
-        dsmeSABSpecification.setSubBlockLengthBytes(subBlockLengthBytes);
-        dsmeSABSpecification.setSubBlockIndex(toDeallocate->getSuperframeID());
-        dsmeSABSpecification.getSubBlock().fill(false);
-        dsmeSABSpecification.getSubBlock().set(
-            toDeallocate->getGTSlotID() * this->dsmeAdaptionLayer.getMAC_PIB().helper.getNumChannels() + toDeallocate->getChannel(), true);
+        dsmeSABSpecification.getSubBlock().set(toDeallocate->getGTSlotID() * numChannels + toDeallocate->getChannel(), true);
+        selectedSlots |= 1 << toDeallocate->getGTSlotID();
+        numSelected++;
+    }
 
-        sendDeallocationRequest(toDeallocate->getAddress(), toDeallocate->getDirection(), dsmeSABSpecification);
+    if(numSelected > 0) {
+        sendDeallocationRequest(decision.deviceAddress, Direction::TX, dsmeSABSpecification);
     }
 }
 
@@ -308,13 +341,13 @@ void GTSHelper::sendDeallocationRequest(uint16_t address, Direction direction, D
     params.direction = direction;
     params.prioritizedChannelAccess = Priority::LOW;
 
-    params.numSlot = 0;               // ignored
+    params.numSlot = sabSpecification.getSubBlock().count(true);
     params.preferredSuperframeId = 0; // ignored
     params.preferredSlotId = 0;       // ignored
 
     params.dsmeSabSpecification = sabSpecification;
 
-    LOG_INFO("Deallocating slot with " << params.deviceAddress << ".");
+    LOG_INFO("Deallocating " << (uint16_t)params.numSlot << " slot(s) with " << params.deviceAddress << ".");
 
     this->dsmeAdaptionLayer.getMLME_SAP().getDSME_GTS().request(params);
 
@@ -365,53 +398,43 @@ GTS GTSHelper::getNextFreeGTS(uint16_t initialSuperframeID, uint8_t initialSlotI
     DSMESlotAllocationBitmap& macDSMESAB = this->dsmeAdaptionLayer.getMAC_PIB().macDSMESAB;
 
     uint8_t numChannels = this->dsmeAdaptionLayer.getMAC_PIB().helper.getNumChannels();
-    uint8_t numSuperFramesPerMultiSuperframe = this->dsmeAdaptionLayer.getMAC_PIB().helper.getNumberSuperframesPerMultiSuperframe();
-    uint16_t slotsToCheck = this->dsmeAdaptionLayer.getMAC_PIB().helper.getNumGTSlots(0) +
-                            (this->dsmeAdaptionLayer.getMAC_PIB().helper.getNumberSuperframesPerMultiSuperframe() - 1) *
-                                this->dsmeAdaptionLayer.getMAC_PIB().helper.getNumGTSlots(1);
-
-    GTS gts(0, 0, 0);
-
-    BitVector<MAX_CHANNELS> occupied;
-    BitVector<MAX_CHANNELS> remoteOccupied; // only used if sabSpec != nullptr
-    occupied.setLength(numChannels);
+    uint16_t allChannels = (1 << numChannels) - 1;
 
     if(sabSpec != nullptr) {
         DSME_ASSERT(sabSpec->getSubBlockIndex() == initialSuperframeID);
-        remoteOccupied.setLength(numChannels);
     }
 
-    for(gts.superframeID = initialSuperframeID; slotsToCheck > 0; gts.superframeID = (gts.superframeID + 1) % numSuperFramesPerMultiSuperframe) {
-        if(sabSpec != nullptr && gts.superframeID != initialSuperframeID) {
-            /* currently per convention a sub block holds exactly one superframe */
-            return GTS::UNDEFINED;
+    if(!macDSMESAB.hasFreeSlots()) {
+        return GTS::UNDEFINED;
+    }
+
+    /* '-> only the initial superframe is searched, starting from the initial slot and wrapping around */
+    GTS gts(initialSuperframeID, 0, 0);
+    uint8_t numGTSlots = this->dsmeAdaptionLayer.getMAC_PIB().helper.getNumGTSlots(gts.superframeID);
+    uint8_t startSlot = initialSlotID % numGTSlots;
+    LOG_INFO("Checking " << numGTSlots << " in superframe " << gts.superframeID);
+
+    uint16_t candidates = macDSMESAB.getFreeSlots(gts.superframeID) & ~macDSMEACT.getAllocatedSlots(gts.superframeID);
+    candidates = ((candidates >> startSlot) | (candidates << (numGTSlots - startSlot))) & ((1 << numGTSlots) - 1);
+
+    while(candidates != 0) {
+        uint8_t offset = __builtin_ctz(candidates);
+        candidates &= candidates - 1;
+        gts.slotID = (startSlot + offset) % numGTSlots;
+
+        uint8_t startChannel = this->dsmeAdaptionLayer.getDSME().getPlatform().getRandom() % numChannels;
+        uint16_t occupied = macDSMESAB.getOccupiedChannels(gts.superframeID, gts.slotID);
+        if(sabSpec != nullptr) {
+            DSME_ASSERT((gts.slotID + 1) * numChannels <= sabSpec->getSubBlock().length());
+            occupied |= sabSpec->getSubBlock().getBits(gts.slotID * numChannels, numChannels);
         }
 
-        uint8_t numGTSlots = this->dsmeAdaptionLayer.getMAC_PIB().helper.getNumGTSlots(gts.superframeID);
-        LOG_INFO("Checking " << numGTSlots << " in superframe " << gts.superframeID);
-        for(gts.slotID = initialSlotID % numGTSlots; slotsToCheck > 0; gts.slotID = (gts.slotID + 1) % numGTSlots) {
-            if(!macDSMEACT.isAllocated(gts.superframeID, gts.slotID)) {
-                uint8_t startChannel = this->dsmeAdaptionLayer.getDSME().getPlatform().getRandom() % numChannels;
-                macDSMESAB.getOccupiedChannels(occupied, gts.superframeID, gts.slotID);
-                if(sabSpec != nullptr) {
-                    remoteOccupied.copyFrom(sabSpec->getSubBlock(), gts.slotID * numChannels);
-                    occupied.setOperationJoin(remoteOccupied);
-                }
-
-                gts.channel = startChannel;
-                for(uint8_t i = 0; i < numChannels; i++) {
-                    if(!occupied.get(gts.channel)) {
-                        /* found one */
-                        return gts;
-                    }
-
-                    gts.channel++;
-                    if(gts.channel == numChannels) {
-                        gts.channel = 0;
-                    }
-                }
-            }
-            slotsToCheck--;
+        uint16_t free = ~occupied & allChannels;
+        if(free != 0) {
+            /* '-> take the first free channel starting from startChannel, wrapping around */
+            uint16_t rotated = ((free >> startChannel) | (free << (numChannels - startChannel))) & allChannels;
+            gts.channel = (startChannel + __builtin_ctz(rotated)) % numChannels;
+            return gts;
         }
     }
 
@@ -428,12 +451,19 @@ GTSStatus::GTS_Status GTSHelper::verifyDeallocation(DSMESABSpecification& reques
     bool foundGts = false;
     bool gtsDifferentAddresses = false;
 
-    for(DSMEAllocationCounterTable::iterator it = macDSMEACT.begin(); it != macDSMEACT.end(); ++it) {
-        abs_slot_idx_t idx = it->getGTSlotID();
-        idx *= numChannels;
-        idx += it->getChannel();
+    uint16_t superframeID = requestSABSpec.getSubBlockIndex();
+    DSMESABSpecification::SABSubBlock& subBlock = requestSABSpec.getSubBlock();
+    bool validSuperframe = superframeID < this->dsmeAdaptionLayer.getMAC_PIB().helper.getNumberSuperframesPerMultiSuperframe();
+
+    /* '-> only the slots requested for deallocation are looked up in the ACT */
+    for(DSMESABSpecification::SABSubBlock::iterator bit = subBlock.beginSetBits(); validSuperframe && bit != subBlock.endSetBits(); ++bit) {
+        uint8_t slotID = (*bit) / numChannels;
+        if(slotID >= this->dsmeAdaptionLayer.getMAC_PIB().helper.getNumGTSlots(superframeID)) {
+            break;
+        }
 
-        if(it->getSuperframeID() != requestSABSpec.getSubBlockIndex() || !requestSABSpec.getSubBlock().get(idx)) {
+        DSMEAllocationCounterTable::iterator it = macDSMEACT.find(superframeID, slotID);
+        if(it == macDSMEACT.end() || it->getChannel() != (*bit) % numChannels) {
             continue; // no deallocation requested
         }
 
@@ -444,8 +474,7 @@ GTSStatus::GTS_Status GTSHelper::verifyDeallocation(DSMESABSpecification& reques
         } else if(deviceAddress == it->getAddress()) {
             foundGts = true;
         } else {
-            DSME_ASSERT(!foundGts); // currently deallocation is only possible with one slot
-            gtsDifferentAddresses = true;
+            gtsDifferentAddresses = true; // a multi-slot deallocation has to cover a single link
         }
     }
 
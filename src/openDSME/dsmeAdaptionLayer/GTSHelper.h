@@ -92,7 +92,7 @@ private:
 
     void checkAndAllocateGTS(GTSSchedulingDecision decision);
 
-    void checkAndDeallocateSingeleGTS(uint16_t address);
+    void checkAndDeallocateGTS(GTSSchedulingDecision decision);
 
     GTS getContiguousFreeGTS();
 
@@ -57,10 +57,14 @@ MessageHelper::MessageHelper(DSMEAdaptionLayer& dsmeAdaptionLayer)
     : dsmeAdaptionLayer(dsmeAdaptionLayer),
 
       scanOrSyncInProgress(false),
-      associationInProgress(false) {
+      associationInProgress(false),
+      numRetries(0),
+      numRetryBufferDroppedFull(0),
+      numRetryBufferDroppedMaxAge(0) {
 }
 
 void MessageHelper::initialize() {
+    this->retryBuffer.setCapacity(this->dsmeAdaptionLayer.getMAC_PIB().macUpperLayerQueueSize);
     this->dsmeAdaptionLayer.getMCPS_SAP().getDATA().indication(DELEGATE(&MessageHelper::handleDataIndication, *this));
     this->dsmeAdaptionLayer.getMCPS_SAP().getDATA().confirm(DELEGATE(&MessageHelper::handleDataConfirm, *this));
     return;
@@ -97,18 +101,38 @@ void MessageHelper::startAssociation() {
 }
 
 void MessageHelper::sendRetryBuffer() {
-    if(!this->retryBuffer.isEmpty()) {
-        DSMEAdaptionLayerBufferEntry* oldestEntry = this->retryBuffer.front();
-        do {
-            IDSMEMessage* currentMessage = this->retryBuffer.front()->message;
-            DSME_ASSERT(!currentMessage->getCurrentlySending());
-
-            this->retryBuffer.pop();
-            sendMessageDown(currentMessage, false);
-        } while((!this->retryBuffer.isEmpty()) && this->retryBuffer.front() != oldestEntry);
+    uint32_t now = this->dsmeAdaptionLayer.getDSME().getPlatform().getSymbolCounter();
+
+    /* a message that fails again is pushed with a later retry time, so this terminates */
+    while(!this->retryBuffer.empty() && static_cast<int32_t>(now - this->retryBuffer.top().nextRetrySymbolCounter) >= 0) {
+        IDSMEMessage* currentMessage = this->retryBuffer.top().message;
+        DSME_ASSERT(!currentMessage->getCurrentlySending());
+        this->retryBuffer.pop();
+
+        if(isRetryAgeExceeded(currentMessage, now)) {
+            LOG_DEBUG("DROPPED->" << currentMessage->getHeader().getDestAddr().getShortAddress() << ": Retry age exceeded ("
+                                  << now - currentMessage->retryBufferSince << " symbols old)");
+            numRetryBufferDroppedMaxAge++;
+            DSME_ASSERT(callback_confirm);
+            callback_confirm(currentMessage, DataStatus::Data_Status::TRANSACTION_EXPIRED);
+            continue;
+        }
+
+        numRetries++;
+        sendMessageDown(currentMessage, false);
     }
 }
 
+void MessageHelper::signalQueueOccupancy() {
+    this->dsmeAdaptionLayer.getDSME().getPlatform().signalQueueOccupancy(RETRY_BUFFER, this->retryBuffer.size(), this->retryBuffer.getHighWaterMark());
+    this->retryBuffer.resetHighWaterMark();
+}
+
+bool MessageHelper::isRetryAgeExceeded(IDSMEMessage* msg, uint32_t now) {
+    uint32_t maxAge = this->dsmeAdaptionLayer.getMAC_PIB().macRetryBufferMaxAge;
+    return maxAge > 0 && now - msg->retryBufferSince >= maxAge;
+}
+
 void MessageHelper::sendMessage(IDSMEMessage* msg) {
     LOG_INFO("Sending DATA message");
     sendMessageDown(msg, true);
@@ -214,35 +238,39 @@ void MessageHelper::handleDataIndication(mcps_sap::DATA_indication_parameters& p
 }
 
 bool MessageHelper::queueMessageIfPossible(IDSMEMessage* msg) {
-    if(this->retryBuffer.isFull()) {
-        DSME_ASSERT(!this->retryBuffer.isEmpty());
-
-        DSMEAdaptionLayerBufferEntry* oldestEntry = this->retryBuffer.front();
-        if(oldestEntry->message == msg) {
-            this->retryBuffer.pop();
-            DSME_ASSERT(!this->retryBuffer.isEmpty());
-            this->retryBuffer.freeElement()->message = msg;
-            this->retryBuffer.freeElement()->initialSymbolCounter = this->dsmeAdaptionLayer.getDSME().getPlatform().getSymbolCounter();
-            this->retryBuffer.pushFreeElement();
-            return true;
-        }
+    const MAC_PIB& pib = this->dsmeAdaptionLayer.getMAC_PIB();
+    uint32_t now = this->dsmeAdaptionLayer.getDSME().getPlatform().getSymbolCounter();
+
+    if(msg->retryBufferAttempts == 0) {
+        msg->retryBufferSince = now;
+    } else if(isRetryAgeExceeded(msg, now)) {
+        LOG_DEBUG("DROPPED->" << msg->getHeader().getDestAddr().getShortAddress() << ": Retry age exceeded (" << now - msg->retryBufferSince
+                              << " symbols old)");
+        numRetryBufferDroppedMaxAge++;
+        return false;
+    }
 
-        if(!oldestEntry->message->getCurrentlySending()) {
-            uint32_t currentSymbolCounter = this->dsmeAdaptionLayer.getDSME().getPlatform().getSymbolCounter();
-            LOG_DEBUG("DROPPED->" << oldestEntry->message->getHeader().getDestAddr().getShortAddress() << ": Retry-Queue overflow ("
-                                  << currentSymbolCounter - oldestEntry->initialSymbolCounter << " symbols old)");
-            DSME_ASSERT(callback_confirm);
-            callback_confirm(oldestEntry->message, DataStatus::Data_Status::INVALID_GTS); // TODO change if queue is used for retransmissions
-            this->retryBuffer.pop();
-        }
+    /* exponential back-off, so that a missing GTS is not polled by every buffered message at once */
+    uint8_t exponent = (msg->retryBufferAttempts < pib.macRetryBufferMaxBackoffExponent) ? msg->retryBufferAttempts : pib.macRetryBufferMaxBackoffExponent;
+    uint32_t backoff = pib.macRetryBufferBackoff;
+    if(backoff > 0 && (exponent >= 31 || backoff > (static_cast<uint32_t>(INT32_MAX) >> exponent))) {
+        /* '-> saturated, the wrapping symbol counter is only compared within half of its range */
+        backoff = INT32_MAX;
+    } else {
+        backoff <<= exponent;
     }
-    if(!this->retryBuffer.isEmpty()) {
-        this->retryBuffer.freeElement()->message = msg;
-        this->retryBuffer.freeElement()->initialSymbolCounter = this->dsmeAdaptionLayer.getDSME().getPlatform().getSymbolCounter();
-        this->retryBuffer.pushFreeElement();
-        return true; /* Do NOT release current message yet */
+
+    DSMEAdaptionLayerBufferEntry entry;
+    entry.message = msg;
+    entry.nextRetrySymbolCounter = now + (backoff > 0 ? backoff : 1);
+    if(!this->retryBuffer.push(entry)) {
+        LOG_DEBUG("DROPPED->" << msg->getHeader().getDestAddr().getShortAddress() << ": Retry-Queue overflow");
+        numRetryBufferDroppedFull++;
+        return false;
     }
-    return false;
+
+    msg->retryBufferAttempts++;
+    return true; /* Do NOT release current message yet */
 }
 
 void MessageHelper::handleDataConfirm(mcps_sap::DATA_confirm_parameters& params) {
@@ -45,8 +45,8 @@
 
 #include "../../dsme_settings.h"
 #include "../helper/DSMEDelegate.h"
-#include "../helper/DSMERingbuffer.h"
 #include "../mac_services/DSME_Common.h"
+#include "../mac_services/dataStructures/MinHeap.h"
 
 namespace dsme {
 
@@ -63,7 +63,12 @@ struct DATA_indication_parameters;
 struct DSMEAdaptionLayerBufferEntry {
 public:
     IDSMEMessage* message;
-    uint32_t initialSymbolCounter;
+    uint32_t nextRetrySymbolCounter;
+
+    bool operator<(const DSMEAdaptionLayerBufferEntry& other) const {
+        /* the symbol counter wraps, so compare the signed difference */
+        return static_cast<int32_t>(this->nextRetrySymbolCounter - other.nextRetrySymbolCounter) < 0;
+    }
 };
 
 class MessageHelper {
@@ -79,8 +84,29 @@ public:
     void setConfirmCallback(confirmCallback_t);
 
     void sendMessage(IDSMEMessage* msg);
+
+    /*
+     * Resubmits the buffered messages whose retry time has arrived, O(log n) per resubmitted message
+     */
     void sendRetryBuffer();
 
+    /*
+     * Reports the occupancy and high-water mark of the retry buffer to the platform and restarts the high-water mark
+     */
+    void signalQueueOccupancy();
+
+    long getNumRetries() const {
+        return numRetries;
+    }
+
+    long getNumRetryBufferDroppedFull() const {
+        return numRetryBufferDroppedFull;
+    }
+
+    long getNumRetryBufferDroppedMaxAge() const {
+        return numRetryBufferDroppedMaxAge;
+    }
+
     void startAssociation();
     void handleAssociationComplete(AssociationStatus::Association_Status status);
     void handleScanAndSyncComplete(PANDescriptor* panDescriptor);
@@ -102,7 +128,14 @@ private:
     bool scanOrSyncInProgress;
     bool associationInProgress;
 
-    DSMERingBuffer<DSMEAdaptionLayerBufferEntry, UPPER_LAYER_QUEUE_SIZE> retryBuffer;
+    bool isRetryAgeExceeded(IDSMEMessage* msg, uint32_t now);
+
+    /* messages waiting for a GTS, ordered by the time of their next retry */
+    MinHeap<DSMEAdaptionLayerBufferEntry> retryBuffer;
+
+    long numRetries;
+    long numRetryBufferDroppedFull;
+    long numRetryBufferDroppedMaxAge;
 };
 
 } /* namespace dsme */
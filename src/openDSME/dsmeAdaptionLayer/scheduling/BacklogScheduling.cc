@@ -0,0 +1,227 @@
+/*
+ * openDSME
+ *
+ * Implementation of the Deterministic & Synchronous Multi-channel Extension (DSME)
+ * described in the IEEE 802.15.4-2015 standard
+ *
+ * Authors: Florian Kauer <florian.kauer@tuhh.de>
+ *          Maximilian Koestler <maximilian.koestler@tuhh.de>
+ *          Sandrina Backhauss <sandrina.backhauss@tuhh.de>
+ *
+ * Based on
+ *          DSME Implementation for the INET Framework
+ *          Tobias Luebkert <tobias.luebkert@tuhh.de>
+ *
+ * Copyright (c) 2015, Institute of Telematics, Hamburg University of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "./BacklogScheduling.h"
+
+#include "../../../dsme_platform.h"
+#include "../../dsmeLayer/DSMELayer.h"
+#include "../../mac_services/dataStructures/IEEE802154MacAddress.h"
+#include "../../mac_services/pib/MAC_PIB.h"
+#include "../DSMEAdaptionLayer.h"
+
+/* fixed point fraction bits of the average arrival rate */
+#define ARRIVAL_SHIFT 8
+
+/* weight 1/2^EWMA_SHIFT of a new sample */
+#define EWMA_SHIFT 3
+
+namespace dsme {
+
+static uint32_t ewma(uint32_t average, uint32_t sample) {
+    return average - (average >> EWMA_SHIFT) + (sample >> EWMA_SHIFT);
+}
+
+BacklogSchedulingData::BacklogSchedulingData() : backlog(0), avgArrivals(0), avgMessageServiceTime(0), multisuperframesSinceLastPacket(0) {
+}
+
+void BacklogScheduling::setMaxQueueingDelay(uint32_t maxQueueingDelay) {
+    this->maxQueueingDelay = maxQueueingDelay;
+}
+
+void BacklogScheduling::setMaxSlotsPerRequest(uint8_t maxSlotsPerRequest) {
+    DSME_ASSERT(maxSlotsPerRequest > 0);
+    this->maxSlotsPerRequest = maxSlotsPerRequest;
+}
+
+void BacklogScheduling::setMinFreshness(uint16_t minFreshness) {
+    DSME_ASSERT(minFreshness > 0);
+    this->minFreshness = minFreshness;
+}
+
+uint8_t BacklogScheduling::registerIncomingMessage(uint16_t address) {
+    uint8_t queueLevel = GTSSchedulingImpl::registerIncomingMessage(address);
+
+    iterator it = this->txLinks.find(address);
+    if(it == this->txLinks.end()) {
+        return queueLevel;
+    }
+
+    if(it->backlog < 0xFFFF) {
+        it->backlog++;
+    }
+    it->multisuperframesSinceLastPacket = 0;
+
+    return queueLevel;
+}
+
+void BacklogScheduling::registerOutgoingMessage(uint16_t address, bool success, int32_t serviceTime, uint8_t queueAtCreation) {
+    GTSSchedulingImpl::registerOutgoingMessage(address, success, serviceTime, queueAtCreation);
+
+    iterator it = this->txLinks.find(address);
+    if(it == this->txLinks.end()) {
+        return;
+    }
+
+    if(it->backlog > 0) {
+        it->backlog--;
+    }
+
+    /* '-> the message waited for all messages queued before it, so the share of a single message
+     *     is the service time divided by the queue level at its creation */
+    if(success && serviceTime > 0 && queueAtCreation != 0 && queueAtCreation != 0xFF) {
+        uint32_t sample = (uint32_t)serviceTime / queueAtCreation;
+        if(it->avgMessageServiceTime == 0) {
+            it->avgMessageServiceTime = sample;
+        } else {
+            it->avgMessageServiceTime = ewma(it->avgMessageServiceTime, sample);
+        }
+    }
+}
+
+bool BacklogScheduling::isIdleLink(const BacklogSchedulingData& data) {
+    return data.backlog == 0 && GTSSchedulingImpl::isIdleLink(data);
+}
+
+int16_t BacklogScheduling::computeSlotTarget(const BacklogSchedulingData& data) {
+    if(data.backlog == 0 && data.multisuperframesSinceLastPacket > minFreshness) {
+        return 0;
+    }
+
+    const PIBHelper& helper = this->dsmeAdaptionLayer.getMAC_PIB().helper;
+
+    /* '-> every slot serves one message per multi-superframe, so keeping up with the arrivals requires one slot per arrival */
+    uint64_t target = (data.avgArrivals + (1 << ARRIVAL_SHIFT) - 1) >> ARRIVAL_SHIFT;
+
+    if(maxQueueingDelay > 0) {
+        /* '-> additionally drain the current backlog within the delay target */
+        uint32_t delayMultiSuperframes = maxQueueingDelay / helper.getSymbolsPerMultiSuperframe();
+        if(delayMultiSuperframes == 0) {
+            delayMultiSuperframes = 1;
+        }
+        target += (data.backlog + delayMultiSuperframes - 1) / delayMultiSuperframes;
+
+        /* '-> scale the current allocation if the measured service time predicts a violation of the delay target */
+        uint64_t predictedDelay = (uint64_t)(data.backlog + 1) * data.avgMessageServiceTime;
+        if(predictedDelay > maxQueueingDelay) {
+            uint64_t slots = this->dsmeAdaptionLayer.getMAC_PIB().macDSMEACT.getNumAllocatedGTS(data.address, Direction::TX);
+            if(slots == 0) {
+                slots = 1;
+            }
+            uint64_t scaled = (slots * predictedDelay + maxQueueingDelay - 1) / maxQueueingDelay;
+            if(scaled > target) {
+                target = scaled;
+            }
+        }
+    }
+
+    uint64_t maxSlots = helper.getNumGTSlots(0) + (uint64_t)(helper.getNumberSuperframesPerMultiSuperframe() - 1) * helper.getNumGTSlots(1);
+    if(target > maxSlots) {
+        target = maxSlots;
+    }
+    if(target == 0) {
+        target = 1;
+    }
+
+    return target;
+}
+
+void BacklogScheduling::multisuperframeEvent() {
+    for(BacklogSchedulingData& data : this->txLinks) {
+        data.avgArrivals = ewma(data.avgArrivals, (uint32_t)data.messagesInLastMultisuperframe << ARRIVAL_SHIFT);
+
+        if(data.messagesInLastMultisuperframe == 0) {
+            if(data.multisuperframesSinceLastPacket < 0xFFFE) {
+                data.multisuperframesSinceLastPacket++;
+            }
+        } else {
+            data.multisuperframesSinceLastPacket = 0;
+        }
+
+        data.slotTarget = computeSlotTarget(data);
+
+        LOG_DEBUG("backlog,0x" << HEXOUT << this->dsmeAdaptionLayer.getDSME().getMAC_PIB().macShortAddress << ",0x" << data.address << "," << DECOUT
+                               << data.messagesInLastMultisuperframe << "," << data.messagesOutLastMultisuperframe << "," << data.backlog << ","
+                               << data.avgMessageServiceTime << "," << data.slotTarget);
+
+        data.messagesInLastMultisuperframe = 0;
+        data.messagesOutLastMultisuperframe = 0;
+    }
+}
+
+GTSSchedulingDecision BacklogScheduling::getNextSchedulingAction(uint16_t address) {
+    iterator it = this->txLinks.find(address);
+    if(it == this->txLinks.end()) {
+        return NO_SCHEDULING_ACTION;
+    }
+
+    /* '-> recompute on demand to react to bursts within the current multi-superframe */
+    it->slotTarget = computeSlotTarget(*it);
+
+    int16_t numAllocatedSlots = this->dsmeAdaptionLayer.getMAC_PIB().macDSMEACT.getNumAllocatedGTS(address, Direction::TX);
+
+    if(it->slotTarget > numAllocatedSlots) {
+        int16_t numSlot = it->slotTarget - numAllocatedSlots;
+        if(numSlot > maxSlotsPerRequest) {
+            numSlot = maxSlotsPerRequest;
+        }
+
+        uint8_t numSuperFramesPerMultiSuperframe = this->dsmeAdaptionLayer.getMAC_PIB().helper.getNumberSuperframesPerMultiSuperframe();
+        uint8_t randomSuperframeID = this->dsmeAdaptionLayer.getRandom() % numSuperFramesPerMultiSuperframe;
+
+        uint8_t numGTSlots = this->dsmeAdaptionLayer.getMAC_PIB().helper.getNumGTSlots(randomSuperframeID);
+        uint8_t randomSlotID = this->dsmeAdaptionLayer.getRandom() % numGTSlots;
+
+        return GTSSchedulingDecision{address, ManagementType::ALLOCATION, Direction::TX, (uint8_t)numSlot, randomSuperframeID, randomSlotID};
+    } else if(it->slotTarget + 1 < numAllocatedSlots) {
+        /* '-> hysteresis of one slot, the last slot is left to the GTS expiration */
+        int16_t numSlot = numAllocatedSlots - (it->slotTarget > 0 ? it->slotTarget : 1);
+        if(numSlot > maxSlotsPerRequest) {
+            numSlot = maxSlotsPerRequest;
+        }
+
+        return GTSSchedulingDecision{address, ManagementType::DEALLOCATION, Direction::TX, (uint8_t)numSlot, 0, 0};
+    } else {
+        return NO_SCHEDULING_ACTION;
+    }
+}
+
+} /* namespace dsme */
@@ -0,0 +1,95 @@
+/*
+ * openDSME
+ *
+ * Implementation of the Deterministic & Synchronous Multi-channel Extension (DSME)
+ * described in the IEEE 802.15.4-2015 standard
+ *
+ * Authors: Florian Kauer <florian.kauer@tuhh.de>
+ *          Maximilian Koestler <maximilian.koestler@tuhh.de>
+ *          Sandrina Backhauss <sandrina.backhauss@tuhh.de>
+ *
+ * Based on
+ *          DSME Implementation for the INET Framework
+ *          Tobias Luebkert <tobias.luebkert@tuhh.de>
+ *
+ * Copyright (c) 2015, Institute of Telematics, Hamburg University of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef BACKLOGSCHEDULING_H_
+#define BACKLOGSCHEDULING_H_
+
+#include "./GTSScheduling.h"
+
+namespace dsme {
+
+class DSMEAdaptionLayer;
+
+struct BacklogSchedulingData : GTSSchedulingData {
+    BacklogSchedulingData();
+
+    uint16_t backlog;               // messages currently queued for this link
+    uint32_t avgArrivals;           // EWMA of the arrivals per multi-superframe, fixed point
+    uint32_t avgMessageServiceTime; // EWMA of the service time of a single message in symbols
+    uint16_t multisuperframesSinceLastPacket;
+};
+
+/*
+ * Derives the slot target of a link from its current backlog and arrival rate so that
+ * the backlog is drained within the configured maximum queueing delay.
+ * The service time and queue level reported for each transmitted message are used to
+ * predict the queueing delay of the current backlog and scale up the allocation if the
+ * prediction exceeds the delay target. Several slots are requested or released at once.
+ */
+class BacklogScheduling : public GTSSchedulingImpl<BacklogSchedulingData, GTSRxData> {
+public:
+    BacklogScheduling(DSMEAdaptionLayer& dsmeAdaptionLayer) : GTSSchedulingImpl(dsmeAdaptionLayer) {
+    }
+
+    virtual uint8_t registerIncomingMessage(uint16_t address);
+    virtual void registerOutgoingMessage(uint16_t address, bool success, int32_t serviceTime, uint8_t queueAtCreation);
+    virtual void multisuperframeEvent();
+    virtual GTSSchedulingDecision getNextSchedulingAction(uint16_t address);
+
+    void setMaxQueueingDelay(uint32_t maxQueueingDelay);
+    void setMaxSlotsPerRequest(uint8_t maxSlotsPerRequest);
+    void setMinFreshness(uint16_t freshness);
+
+protected:
+    virtual bool isIdleLink(const BacklogSchedulingData& data);
+
+private:
+    int16_t computeSlotTarget(const BacklogSchedulingData& data);
+
+    uint32_t maxQueueingDelay{0}; // in symbols, 0 only considers the arrival rate
+    uint8_t maxSlotsPerRequest{1};
+    uint16_t minFreshness{0xFFFF};
+};
+
+} /* namespace dsme */
+
+#endif /* BACKLOGSCHEDULING_H_ */
@@ -43,6 +43,7 @@
 #ifndef GTSSCHEDULING_H_
 #define GTSSCHEDULING_H_
 
+#include "../../../dsme_platform.h"
 #include "../../mac_services/DSME_Common.h"
 #include "../../mac_services/dataStructures/IEEE802154MacAddress.h"
 #include "../../mac_services/dataStructures/RBTree.h"
@@ -88,6 +89,7 @@ public:
     }
 
     virtual ~GTSScheduling() = default;
+    virtual void initialize(uint16_t maxLinks) = 0;
     virtual void reset() = 0;
     virtual uint8_t registerIncomingMessage(uint16_t address) = 0;
     virtual void registerOutgoingMessage(uint16_t address, bool success, int32_t serviceTime, uint8_t queueAtCreation) = 0;
@@ -97,6 +99,7 @@ public:
     virtual uint16_t getPriorityLink() = 0;
     virtual GTSSchedulingDecision getNextSchedulingAction(uint16_t address) = 0;
     virtual GTSSchedulingDecision getNextSchedulingAction() = 0;
+    virtual uint32_t getAllocatedMemory() const = 0;
 
 protected:
     DSMEAdaptionLayer& dsmeAdaptionLayer;
@@ -105,13 +108,26 @@ protected:
 template <typename SchedulingData, typename RxData>
 class GTSSchedulingImpl : public GTSScheduling {
 public:
-    typedef typename RBTree<SchedulingData, uint16_t>::iterator iterator;
+    typedef RBTreeIterator<SchedulingData, uint16_t> iterator;
 
     GTSSchedulingImpl(DSMEAdaptionLayer& dsmeAdaptionLayer) : GTSScheduling(dsmeAdaptionLayer) {
     }
 
     virtual ~GTSSchedulingImpl() = default;
 
+    /*
+     * Allocates the nodes for the links, has to be called before the first message is registered
+     * @param maxLinks maximum number of TX and of RX links, usually the neighbor limit
+     */
+    virtual void initialize(uint16_t maxLinks) {
+        this->txLinks.getAllocator().initialize(maxLinks);
+        this->rxLinks.getAllocator().initialize(maxLinks);
+    }
+
+    virtual uint32_t getAllocatedMemory() const {
+        return this->txLinks.getAllocator().getAllocatedMemory() + this->rxLinks.getAllocator().getAllocatedMemory();
+    }
+
     virtual void reset() {
         while(this->txLinks.size() > 0) {
             auto it = this->txLinks.begin();
@@ -130,7 +146,9 @@ public:
             SchedulingData data;
             data.address = address;
             data.messagesInLastMultisuperframe++;
-            this->txLinks.insert(data, address);
+            if(!this->txLinks.insert(data, address) && (!evictIdleLink() || !this->txLinks.insert(data, address))) {
+                LOG_ERROR("No room for the link to 0x" << HEXOUT << address << DECOUT << ".");
+            }
         } else {
             it->messagesInLastMultisuperframe++;
         }
@@ -153,7 +171,7 @@ public:
             RxData data;
             data.address = address;
             data.messagesRxLastMultisuperframe++;
-            this->rxLinks.insert(data, address);
+            this->rxLinks.insert(data, address); /* '-> only statistics, dropped if the pool is exhausted */
         } else {
             it->messagesRxLastMultisuperframe++;
         }
@@ -161,6 +179,9 @@ public:
 
     virtual int16_t getSlotTarget(uint16_t address) {
         iterator it = this->txLinks.find(address);
+        if(it == this->txLinks.end()) {
+            return 0;
+        }
 
         return it->slotTarget;
     }
@@ -188,6 +209,10 @@ public:
     }
 
     virtual GTSSchedulingDecision getNextSchedulingAction(uint16_t address) {
+        if(this->txLinks.find(address) == this->txLinks.end()) {
+            return NO_SCHEDULING_ACTION;
+        }
+
         uint16_t numAllocatedSlots = this->dsmeAdaptionLayer.getMAC_PIB().macDSMEACT.getNumAllocatedGTS(address, Direction::TX);
 
         int16_t target = getSlotTarget(address);
@@ -199,10 +224,22 @@ public:
             uint8_t numGTSlots = this->dsmeAdaptionLayer.getMAC_PIB().helper.getNumGTSlots(randomSuperframeID);
             uint8_t randomSlotID = this->dsmeAdaptionLayer.getRandom() % numGTSlots;
 
-            return GTSSchedulingDecision{address, ManagementType::ALLOCATION, Direction::TX, 1, randomSuperframeID, randomSlotID};
+            /* '-> the whole difference is requested at once, the GTSHelper limits it to a single superframe */
+            uint16_t numSlot = target - numAllocatedSlots;
+            if(numSlot > 0xFF) {
+                numSlot = 0xFF;
+            }
+
+            return GTSSchedulingDecision{address, ManagementType::ALLOCATION, Direction::TX, (uint8_t)numSlot, randomSuperframeID, randomSlotID};
         } else if(target < numAllocatedSlots && numAllocatedSlots > 1) {
-            /* TODO: slot and superframe ID are currently ignored for DEALLOCATION */
-            return GTSSchedulingDecision{address, ManagementType::DEALLOCATION, Direction::TX, 1, 0, 0};
+            /* '-> the last slot is left to the GTS expiration */
+            uint16_t numSlot = numAllocatedSlots - (target > 0 ? target : 1);
+            if(numSlot > 0xFF) {
+                numSlot = 0xFF;
+            }
+
+            /* '-> slot and superframe ID are ignored, the GTSHelper selects the slots to release */
+            return GTSSchedulingDecision{address, ManagementType::DEALLOCATION, Direction::TX, (uint8_t)numSlot, 0, 0};
         } else {
             return NO_SCHEDULING_ACTION;
         }
@@ -218,8 +255,31 @@ public:
     }
 
 protected:
-    RBTree<SchedulingData, uint16_t> txLinks;
-    RBTree<RxData, uint16_t> rxLinks;
+    /*
+     * A link without allocated TX slots and without messages in the current multi-superframe can be dropped,
+     * it is created again with the next message.
+     */
+    virtual bool isIdleLink(const SchedulingData& data) {
+        return data.messagesInLastMultisuperframe == 0 && this->dsmeAdaptionLayer.getMAC_PIB().macDSMEACT.getNumAllocatedGTS(data.address, Direction::TX) == 0;
+    }
+
+    /*
+     * Removes an idle link to make room for a new one when the node pool is exhausted
+     * @return true if a link was removed
+     */
+    bool evictIdleLink() {
+        for(iterator it = this->txLinks.begin(); it != this->txLinks.end(); ++it) {
+            if(isIdleLink(*it)) {
+                LOG_INFO("Dropping idle link to 0x" << HEXOUT << it->address << DECOUT << ".");
+                this->txLinks.remove(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    RBTree<SchedulingData, uint16_t, RBRuntimeNodePool<SchedulingData, uint16_t>> txLinks;
+    RBTree<RxData, uint16_t, RBRuntimeNodePool<RxData, uint16_t>> rxLinks;
     uint8_t queueLevel = 0;
 };
 
@@ -55,8 +55,9 @@ namespace dsme {
 
 void StaticScheduling::multisuperframeEvent() {
     // Reset the idle counters of the slots to prevent deallocation 
-    for(DSMEAllocationCounterTable::iterator it = dsmeAdaptionLayer.getMAC_PIB().macDSMEACT.begin(); it != dsmeAdaptionLayer.getMAC_PIB().macDSMEACT.end(); ++it) {
-        it->resetIdleCounter();
+    DSMEAllocationCounterTable& act = dsmeAdaptionLayer.getMAC_PIB().macDSMEACT;
+    for(DSMEAllocationCounterTable::iterator it = act.begin(); it != act.end(); ++it) {
+        act.resetIdleCounter(it);
     }
 
     // Set priority for the right links 
@@ -48,46 +48,116 @@
 #include "./DSMELayer.h"
 #include "./ackLayer/AckLayer.h"
 #include "./capLayer/CAPLayer.h"
+#include "./messageDispatcher/MessageDispatcher.h"
 
 namespace dsme {
 
-DSMEEventDispatcher::DSMEEventDispatcher(DSMELayer& dsme) : DSMETimerMultiplexer(this, NOW, TIMER), dsme(dsme) {
+DSMEEventDispatcher::DSMEEventDispatcher(DSMELayer& dsme) : DSMETimerMultiplexer(this, NOW, TIMER), dsme(dsme), useNativeTimers(false) {
+    for(uint8_t i = 0; i < EventTimers::TIMER_COUNT; ++i) {
+        this->nativeTimerDeadlines[i] = 0;
+    }
 }
 
 void DSMEEventDispatcher::initialize() {
     this->NOW.initialize(&(this->dsme.getPlatform()), &IDSMEPlatform::getSymbolCounter);
     this->TIMER.initialize(&(this->dsme.getPlatform()), &IDSMEPlatform::startTimer);
 
+    this->useNativeTimers = this->dsme.getPlatform().hasNativeTimers();
+
     DSMETimerMultiplexer::_initialize();
 }
 
 void DSMEEventDispatcher::reset() {
+    if(this->useNativeTimers) {
+        for(uint8_t i = 0; i < EventTimers::TIMER_COUNT; ++i) {
+            stopNativeTimer(static_cast<EventTimers>(i));
+        }
+        return;
+    }
+
     _reset();
     return;
 }
 
 void DSMEEventDispatcher::timerInterrupt() {
+    DSME_ASSERT(!this->useNativeTimers);
     DSMETimerMultiplexer::_timerInterrupt();
 }
 
+void DSMEEventDispatcher::nativeTimerInterrupt(uint8_t timer) {
+    DSME_ASSERT(this->useNativeTimers);
+    DSME_ASSERT(timer < EventTimers::TIMER_COUNT);
+
+    /* The difference also works if there was a wrap around (modulo by casting to uint32_t). */
+    int32_t lateness = (uint32_t)(NOW - this->nativeTimerDeadlines[timer]);
+
+    switch(timer) {
+        case NEXT_PRE_SLOT:
+            firePreSlotTimer(lateness);
+            break;
+        case NEXT_SLOT:
+            fireSlotTimer(lateness);
+            break;
+        case CSMA_TIMER:
+            fireCSMATimer(lateness);
+            break;
+        case ACK_TIMER:
+            fireACKTimer(lateness);
+            break;
+        case GTS_FRAME_TIMER:
+            fireGTSFrameTimer(lateness);
+            break;
+        default:
+            DSME_ASSERT(false);
+    }
+}
+
+void DSMEEventDispatcher::startNativeTimer(EventTimers timer, uint32_t symbolCounterValue) {
+    this->nativeTimerDeadlines[timer] = symbolCounterValue;
+    this->dsme.getPlatform().startNativeTimer(timer, symbolCounterValue);
+}
+
+void DSMEEventDispatcher::stopNativeTimer(EventTimers timer) {
+    this->dsme.getPlatform().stopNativeTimer(timer);
+}
+
 /********** Event Handlers **********/
 
 void DSMEEventDispatcher::firePreSlotTimer(int32_t lateness) {
+#ifdef STATISTICS_MONITOR_LATENESS
+    this->dsme.getPlatform().signalTimerLateness(NEXT_PRE_SLOT, lateness);
+#endif
     this->dsme.preSlotEvent();
 }
 
 void DSMEEventDispatcher::fireSlotTimer(int32_t lateness) {
+#ifdef STATISTICS_MONITOR_LATENESS
+    this->dsme.getPlatform().signalTimerLateness(NEXT_SLOT, lateness);
+#endif
     this->dsme.slotEvent(lateness);
 }
 
 void DSMEEventDispatcher::fireCSMATimer(int32_t lateness) {
+#ifdef STATISTICS_MONITOR_LATENESS
+    this->dsme.getPlatform().signalTimerLateness(CSMA_TIMER, lateness);
+#endif
     this->dsme.getCapLayer().dispatchTimerEvent();
 }
 
 void DSMEEventDispatcher::fireACKTimer(int32_t lateness) {
+#ifdef STATISTICS_MONITOR_LATENESS
+    this->dsme.getPlatform().signalTimerLateness(ACK_TIMER, lateness);
+#endif
     this->dsme.getAckLayer().dispatchTimer();
 }
 
+void DSMEEventDispatcher::fireGTSFrameTimer(int32_t lateness) {
+#ifdef STATISTICS_MONITOR_LATENESS
+    this->dsme.getPlatform().signalTimerLateness(GTS_FRAME_TIMER, lateness);
+#endif
+    this->dsme.getMessageDispatcher().handleGTSFrameTimer();
+}
+
 /********** Setup Methods **********/
 
 uint32_t DSMEEventDispatcher::setupSlotTimer(uint32_t lastSlotTime, uint8_t skippedSlots) {
@@ -98,9 +168,14 @@ uint32_t DSMEEventDispatcher::setupSlotTimer(uint32_t lastSlotTime, uint8_t skip
         if(next_slot_time - PRE_EVENT_SHIFT <= NOW + 1) {
             next_slot_time += symbols_per_slot;
         }
-        DSMETimerMultiplexer::_startTimer<NEXT_SLOT>(next_slot_time, &DSMEEventDispatcher::fireSlotTimer);
-        DSMETimerMultiplexer::_startTimer<NEXT_PRE_SLOT>(next_slot_time - PRE_EVENT_SHIFT, &DSMEEventDispatcher::firePreSlotTimer);
-        DSMETimerMultiplexer::_scheduleTimer();
+        if(this->useNativeTimers) {
+            startNativeTimer(NEXT_SLOT, next_slot_time);
+            startNativeTimer(NEXT_PRE_SLOT, next_slot_time - PRE_EVENT_SHIFT);
+        } else {
+            DSMETimerMultiplexer::_startTimer<NEXT_SLOT>(next_slot_time, &DSMEEventDispatcher::fireSlotTimer);
+            DSMETimerMultiplexer::_startTimer<NEXT_PRE_SLOT>(next_slot_time - PRE_EVENT_SHIFT, &DSMEEventDispatcher::firePreSlotTimer);
+            DSMETimerMultiplexer::_scheduleTimer();
+        }
     }
 
     return next_slot_time;
@@ -108,8 +183,12 @@ uint32_t DSMEEventDispatcher::setupSlotTimer(uint32_t lastSlotTime, uint8_t skip
 
 void DSMEEventDispatcher::setupCSMATimer(uint32_t absSymCnt) {
     DSME_ATOMIC_BLOCK {
-        DSMETimerMultiplexer::_startTimer<CSMA_TIMER>(absSymCnt, &DSMEEventDispatcher::fireCSMATimer);
-        DSMETimerMultiplexer::_scheduleTimer();
+        if(this->useNativeTimers) {
+            startNativeTimer(CSMA_TIMER, absSymCnt);
+        } else {
+            DSMETimerMultiplexer::_startTimer<CSMA_TIMER>(absSymCnt, &DSMEEventDispatcher::fireCSMATimer);
+            DSMETimerMultiplexer::_scheduleTimer();
+        }
     }
     return;
 }
@@ -117,16 +196,36 @@ void DSMEEventDispatcher::setupCSMATimer(uint32_t absSymCnt) {
 void DSMEEventDispatcher::setupACKTimer() {
     DSME_ATOMIC_BLOCK {
         uint32_t ackTimeout = dsme.getMAC_PIB().helper.getAckWaitDuration() + NOW;
-        DSMETimerMultiplexer::_startTimer<ACK_TIMER>(ackTimeout, &DSMEEventDispatcher::fireACKTimer);
-        DSMETimerMultiplexer::_scheduleTimer();
+        if(this->useNativeTimers) {
+            startNativeTimer(ACK_TIMER, ackTimeout);
+        } else {
+            DSMETimerMultiplexer::_startTimer<ACK_TIMER>(ackTimeout, &DSMEEventDispatcher::fireACKTimer);
+            DSMETimerMultiplexer::_scheduleTimer();
+        }
     }
     return;
 }
 
 void DSMEEventDispatcher::stopACKTimer() {
     DSME_ATOMIC_BLOCK {
-        DSMETimerMultiplexer::_stopTimer<ACK_TIMER>();
-        DSMETimerMultiplexer::_scheduleTimer();
+        if(this->useNativeTimers) {
+            stopNativeTimer(ACK_TIMER);
+        } else {
+            DSMETimerMultiplexer::_stopTimer<ACK_TIMER>();
+            DSMETimerMultiplexer::_scheduleTimer();
+        }
+    }
+    return;
+}
+
+void DSMEEventDispatcher::setupGTSFrameTimer(uint32_t absSymCnt) {
+    DSME_ATOMIC_BLOCK {
+        if(this->useNativeTimers) {
+            startNativeTimer(GTS_FRAME_TIMER, absSymCnt);
+        } else {
+            DSMETimerMultiplexer::_startTimer<GTS_FRAME_TIMER>(absSymCnt, &DSMEEventDispatcher::fireGTSFrameTimer);
+            DSMETimerMultiplexer::_scheduleTimer();
+        }
     }
     return;
 }
@@ -58,6 +58,7 @@ enum EventTimers {
     NEXT_SLOT,
     CSMA_TIMER,
     ACK_TIMER,
+    GTS_FRAME_TIMER,
     TIMER_COUNT /* always last element */
 };
 
@@ -72,11 +73,13 @@ public:
     void reset();
 
     void timerInterrupt();
+    void nativeTimerInterrupt(uint8_t timer);
 
     uint32_t setupSlotTimer(uint32_t lastSlotTime, uint8_t skippedSlots);
     void setupCSMATimer(uint32_t absSymCnt);
     void setupACKTimer();
     void stopACKTimer();
+    void setupGTSFrameTimer(uint32_t absSymCnt);
 
 private:
     DSMELayer& dsme;
@@ -85,24 +88,20 @@ private:
     void fireSlotTimer(int32_t lateness);
     void fireCSMATimer(int32_t lateness);
     void fireACKTimer(int32_t lateness);
+    void fireGTSFrameTimer(int32_t lateness);
+
+    /**
+     * If the platform provides one timer per event type, the events are scheduled directly
+     * instead of being multiplexed onto a single timer.
+     */
+    bool useNativeTimers;
+    uint32_t nativeTimerDeadlines[EventTimers::TIMER_COUNT];
+
+    void startNativeTimer(EventTimers timer, uint32_t symbolCounterValue);
+    void stopNativeTimer(EventTimers timer);
 
     ReadonlyTimerAbstraction<IDSMEPlatform> NOW;
     WriteonlyTimerAbstraction<IDSMEPlatform> TIMER;
-
-#ifdef STATISTICS_MONITOR_LATENESS
-public:
-    void printLatenessHistogram() {
-        for(uint8_t i = 0; i < EventTimers::TIMER_COUNT; ++i) {
-            LOG_ERROR_PREFIX;
-            LOG_ERROR_PURE(static_cast<uint16_t>(i) << ": ");
-            for(uint16_t j = 0; j < BIN_COUNT; ++j) {
-                LOG_ERROR_PURE(this->lateness_histogram[i][j] << ",");
-            }
-            LOG_ERROR_PURE(LOG_ENDL);
-        }
-        return;
-    }
-#endif
 };
 
 } /* namespace dsme */
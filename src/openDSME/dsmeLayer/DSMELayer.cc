@@ -90,6 +90,7 @@ void DSMELayer::initialize(IDSMEPlatform* platform) {
     this->currentMultiSuperframe = 0;
 
     this->eventDispatcher.initialize();
+    this->capLayer.initialize();
     this->gtsManager.initialize();
     this->messageDispatcher.initialize();
     this->beaconManager.initialize();
@@ -164,6 +165,8 @@ void DSMELayer::doReset() {
 }
 
 void DSMELayer::preSlotEvent(void) {
+    DSME_PROFILE(this->profiler, PROFILE_DSME_LAYER);
+
     if(resetPending) {
         doReset();
         return;
@@ -188,6 +191,8 @@ void DSMELayer::preSlotEvent(void) {
 }
 
 void DSMELayer::slotEvent(int32_t lateness) {
+    DSME_PROFILE(this->profiler, PROFILE_DSME_LAYER);
+
     if(resetPending) {
         doReset();
         return;
@@ -208,8 +213,6 @@ void DSMELayer::slotEvent(int32_t lateness) {
 
     uint32_t currentSlotTime;
 
-    // TODO set timer to next relevant slot only!
-    // TODO in that case currentSlot might be used even if no slotEvent was called before -> calculate then
     if(this->trackingBeacons) {
         auto now = platform->getSymbolCounter();
         currentSlotTime = now - (now - beaconManager.getLastKnownBeaconIntervalStart()) % getMAC_PIB().helper.getSymbolsPerSlot();
@@ -217,16 +220,8 @@ void DSMELayer::slotEvent(int32_t lateness) {
         currentSlotTime = this->nextSlotTime;
     }
 
-    uint8_t skippedSlots = 0;
-    if(currentSlot == 1) { // beginning of CAP
-        if(this->mac_pib->macCapReduction && currentSuperframe > 0) {
-            // no CAP available
-            skippedSlots = 0;
-        } else {
-            // no (pre) slot events required during CAP
-            skippedSlots = 7;
-        }
-    }
+    /* the timer is only set to the next relevant slot, currentSlot and currentSuperframe are recalculated in the preSlotEvent */
+    uint8_t skippedSlots = getNumSkippableSlots(currentSlot, currentSuperframe);
 
     this->nextSlotTime = eventDispatcher.setupSlotTimer(currentSlotTime, skippedSlots);
 
@@ -242,18 +237,41 @@ void DSMELayer::slotEvent(int32_t lateness) {
     }
 }
 
-void DSMELayer::handleStartOfCFP() {
-#ifdef STATISTICS_MONITOR_LATENESS
-    if(latenessStatisticsCount++ % 10 == 0) {
-        this->eventDispatcher.printLatenessHistogram();
+uint8_t DSMELayer::getNumSkippableSlots(uint16_t slot, uint16_t superframe) {
+    uint8_t firstGTS = getMAC_PIB().helper.getFinalCAPSlot(superframe) + 1;
+    DSMEAllocationCounterTable& act = getMAC_PIB().macDSMEACT;
+
+    if(slot >= firstGTS && act.isAllocated(superframe, slot - firstGTS)) {
+        /* '-> the following pre slot event has to release the ACT element and the transceiver */
+        return 0;
+    }
+
+    uint8_t skippedSlots = 0;
+    for(uint16_t next = slot + 1; next < aNumSuperframeSlots; next++) {
+        if(next == 1 || next == firstGTS) {
+            /* '-> start of CAP or start of CFP */
+            break;
+        }
+        if(next > firstGTS && act.isAllocated(superframe, next - firstGTS)) {
+            /* '-> a GTS is allocated in this slot */
+            break;
+        }
+        skippedSlots++;
     }
-#endif
+
+    /* '-> the beacon slot of the next superframe is always relevant */
+    return skippedSlots;
+}
+
+void DSMELayer::handleStartOfCFP() {
+    DSME_PROFILE(this->profiler, PROFILE_DSME_LAYER);
 
     if(this->startOfCFPDelegate) {
         this->startOfCFPDelegate();
     }
 
     this->gtsManager.handleStartOfCFP(this->currentSuperframe);
+    this->messageDispatcher.handleStartOfCFP(this->currentSuperframe);
     this->associationManager.handleStartOfCFP(this->currentSuperframe);
     this->beaconManager.handleStartOfCFP(this->currentSuperframe, this->currentMultiSuperframe);
 }
@@ -262,11 +280,11 @@ uint32_t DSMELayer::getSymbolsSinceCapFrameStart(uint32_t time) {
     uint32_t symbolsSinceLastBeaconInterval = time - this->beaconManager.getLastKnownBeaconIntervalStart();
 
     if(this->mac_pib->macCapReduction) {
-        uint32_t symbolsPerMultiSuperframe = aNumSuperframeSlots * (uint32_t)aBaseSlotDuration * (1 << (uint32_t) this->mac_pib->macMultiSuperframeOrder);
+        uint32_t symbolsPerMultiSuperframe = this->mac_pib->helper.getSymbolsPerMultiSuperframe();
         uint32_t symbolsSinceLastMultiSuperframeStart = symbolsSinceLastBeaconInterval % symbolsPerMultiSuperframe;
         return symbolsSinceLastMultiSuperframeStart;
     } else {
-        uint32_t symbolsPerSuperframe = aNumSuperframeSlots * (uint32_t)aBaseSlotDuration * (1 << (uint32_t) this->mac_pib->macSuperframeOrder);
+        uint32_t symbolsPerSuperframe = this->mac_pib->helper.getSymbolsPerSuperframe();
         uint32_t symbolsSinceLastSuperframeStart = symbolsSinceLastBeaconInterval % symbolsPerSuperframe;
         return symbolsSinceLastSuperframeStart;
     }
@@ -46,6 +46,7 @@
 #include "../../dsme_platform.h"
 #include "../helper/DSMEDelegate.h"
 #include "../helper/DSMEFSM.h"
+#include "../helper/DSMEProfiler.h"
 #include "../helper/Integers.h"
 #include "../interfaces/IDSMEMessage.h"
 #include "../interfaces/IDSMEPlatform.h"
@@ -195,13 +196,19 @@ public:
     void stopTrackingBeacons();
     bool isTrackingBeacons() const;
 
+#ifdef DSME_PROFILING
+    DSMEProfiler& getProfiler() {
+        return this->profiler;
+    }
+#endif
+
 protected:
     IDSMEPlatform* platform;
     DSMEEventDispatcher eventDispatcher;
     Delegate<void()> startOfCFPDelegate;
 
-#ifdef STATISTICS_MONITOR_LATENESS
-    int latenessStatisticsCount;
+#ifdef DSME_PROFILING
+    DSMEProfiler profiler;
 #endif
 
     /* COMPONENTS OF THE DSMELAYER ----------------------------------------> */
@@ -228,6 +235,12 @@ protected:
 
     void doReset();
 
+    /**
+     * Returns the number of slots following the given one that require neither a pre slot nor a slot event.
+     * Those are all slots within the CAP except its first one and all GTS without an entry in the ACT.
+     */
+    uint8_t getNumSkippableSlots(uint16_t slot, uint16_t superframe);
+
     /**
      * Called every slot to display node status in GUI
      * TODO currently platform specific!
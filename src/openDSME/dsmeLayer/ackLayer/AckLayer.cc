@@ -103,6 +103,8 @@ void AckLayer::abortPreparedTransmission() {
 }
 
 void AckLayer::receive(IDSMEMessage* msg) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_ACK_LAYER);
+
     IEEE802154eMACHeader& header = msg->getHeader();
 
     /*
@@ -167,6 +169,8 @@ void AckLayer::receive(IDSMEMessage* msg) {
 }
 
 void AckLayer::dispatchTimer() {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_ACK_LAYER);
+
     if(isDispatchBusy()) {
         return; // already processing (e.g. ACK arrived just in time)
     }
@@ -175,6 +179,8 @@ void AckLayer::dispatchTimer() {
 }
 
 void AckLayer::sendDone(bool success) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_ACK_LAYER);
+
     DSME_ASSERT(!isDispatchBusy());
     bool dispatchSuccessful = dispatch(AckEvent::SEND_DONE, success);
     DSME_ASSERT(dispatchSuccessful);
@@ -123,6 +123,8 @@ void AssociationManager::sendAssociationRequest(DSMEAssociationRequestCmd& req,
 }
 
 void AssociationManager::handleAssociationRequest(IDSMEMessage* msg) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_ASSOCIATION_MANAGER);
+
     DSMEAssociationRequestCmd req;
     req.decapsulateFrom(msg);
 
@@ -174,6 +176,8 @@ void AssociationManager::sendAssociationReply(DSMEAssociationResponseCmd& respon
 }
 
 void AssociationManager::handleAssociationReply(IDSMEMessage* msg) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_ASSOCIATION_MANAGER);
+
     DSME_ATOMIC_BLOCK {
         if(!this->actionPending || this->currentAction != CommandFrameIdentifier::ASSOCIATION_REQUEST) {
             // No association pending, for example because of an ACK timeout
@@ -264,6 +268,8 @@ void AssociationManager::sendDisassociationRequest(DisassociationNotifyCmd& req,
 }
 
 void AssociationManager::handleDisassociationRequest(IDSMEMessage* msg) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_ASSOCIATION_MANAGER);
+
     DisassociationNotifyCmd req;
     req.decapsulateFrom(msg);
 
@@ -278,6 +284,8 @@ void AssociationManager::handleDisassociationRequest(IDSMEMessage* msg) {
  * Gets called when CSMA Message was sent down to the PHY
  */
 void AssociationManager::onCSMASent(IDSMEMessage* msg, CommandFrameIdentifier cmdId, DataStatus::Data_Status status, uint8_t numBackoffs) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_ASSOCIATION_MANAGER);
+
     DSME_ATOMIC_BLOCK {
         if(!this->actionPending) {
             // Already received a response
@@ -362,6 +370,8 @@ void AssociationManager::onCSMASent(IDSMEMessage* msg, CommandFrameIdentifier cm
 }
 
 void AssociationManager::handleStartOfCFP(uint8_t superframe) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_ASSOCIATION_MANAGER);
+
     bool confirmPending = false;
     CommandFrameIdentifier pendingAction = CommandFrameIdentifier::ASSOCIATION_REQUEST;
 
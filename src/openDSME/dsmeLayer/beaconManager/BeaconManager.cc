@@ -143,6 +143,8 @@ void BeaconManager::reset() {
 }
 
 void BeaconManager::preSuperframeEvent(uint16_t nextSuperframe, uint16_t nextMultiSuperframe, uint32_t startSlotTime) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_BEACON_MANAGER);
+
     uint16_t nextSDIndex = nextSuperframe + this->dsme.getMAC_PIB().helper.getNumberSuperframesPerMultiSuperframe() * nextMultiSuperframe;
 
     if((this->isBeaconAllocated || this->dsme.getMAC_PIB().macIsPANCoord) && nextSDIndex == this->dsmePANDescriptor.getBeaconBitmap().getSDIndex()) {
@@ -160,6 +162,8 @@ void BeaconManager::preSuperframeEvent(uint16_t nextSuperframe, uint16_t nextMul
 }
 
 void BeaconManager::superframeEvent(int32_t lateness, uint32_t currentSlotTime) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_BEACON_MANAGER);
+
     if(transmissionPending) {
         if(lateness > 1) {
             dsme.getAckLayer().abortPreparedTransmission();
@@ -464,6 +468,8 @@ void BeaconManager::sendDone(enum AckLayerResponse result, IDSMEMessage* msg) {
 }
 
 void BeaconManager::handleBeacon(IDSMEMessage* msg) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_BEACON_MANAGER);
+
     if(dsme.getMAC_PIB().macIsPANCoord) {
         //* '-> do not handle beacon as PAN coordinator */
         LOG_INFO("A PAN-coordinator does not handle BEACONS -> discard");
@@ -603,6 +609,8 @@ void BeaconManager::startScanPassive(uint16_t scanDuration, const channelList_t&
 }
 
 void BeaconManager::handleStartOfCFP(uint16_t currentSuperframe, uint16_t currentMultiSuperframe) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_BEACON_MANAGER);
+
     if(this->scanning) {
         this->superframesLeftForScan--;
 
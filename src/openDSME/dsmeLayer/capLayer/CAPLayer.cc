@@ -60,6 +60,10 @@ CAPLayer::CAPLayer(DSMELayer& dsme)
     : DSMEBufferedFSM<CAPLayer, CSMAEvent, 4>(&CAPLayer::stateIdle), dsme(dsme), NB(0), NR(0), totalNBs(0), doneCallback(DELEGATE(&CAPLayer::sendDone, *this)) {
 }
 
+void CAPLayer::initialize() {
+    this->queue.initialize(this->dsme.getMAC_PIB().macCAPQueueSize);
+}
+
 void CAPLayer::reset() {
     transition(&CAPLayer::stateIdle);
     this->NB = 0;
@@ -75,16 +79,22 @@ void CAPLayer::reset() {
  * External interfaces
  *****************************/
 void CAPLayer::dispatchTimerEvent() {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_CAP_LAYER);
+
     bool dispatchSuccessful = dispatch(CSMAEvent::TIMER_FIRED);
     DSME_ASSERT(dispatchSuccessful);
 }
 
 void CAPLayer::dispatchCCAResult(bool success) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_CAP_LAYER);
+
     bool dispatchSuccessful = dispatch(success ? CSMAEvent::CCA_SUCCESS : CSMAEvent::CCA_FAILURE);
     DSME_ASSERT(dispatchSuccessful);
 }
 
 void CAPLayer::sendDone(AckLayerResponse response, IDSMEMessage* msg) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_CAP_LAYER);
+
     uint8_t signal;
     switch(response) {
         case AckLayerResponse::NO_ACK_REQUESTED:
@@ -107,6 +117,8 @@ void CAPLayer::sendDone(AckLayerResponse response, IDSMEMessage* msg) {
 }
 
 bool CAPLayer::pushMessage(IDSMEMessage* msg) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_CAP_LAYER);
+
     LOG_DEBUG("push");
 
     bool pushed = false;
@@ -308,7 +320,7 @@ void CAPLayer::actionStartBackoffTimer() {
 
         uint32_t backOfTimeLeft = backoffFromCAPStart;
 
-        const uint16_t superFramesPerMultiSuperframe = 1 << (this->dsme.getMAC_PIB().macMultiSuperframeOrder - this->dsme.getMAC_PIB().macSuperframeOrder);
+        const uint16_t superFramesPerMultiSuperframe = this->dsme.getMAC_PIB().helper.getNumberSuperframesPerMultiSuperframe();
 
         const uint16_t startingSuperframe = 1;
         uint16_t superframeIterator = startingSuperframe;
@@ -70,11 +70,25 @@ class CAPLayer : private DSMEBufferedFSM<CAPLayer, CSMAEvent, 4> {
 public:
     explicit CAPLayer(DSMELayer& dsme);
 
+    void initialize();
     void reset();
     bool pushMessage(IDSMEMessage* msg);
     void dispatchTimerEvent();
     void dispatchCCAResult(bool success);
 
+    uint16_t getQueueSize() const {
+        return queue.getSize();
+    }
+
+    /* maximum queue size since the last resetQueueHighWaterMark() */
+    uint16_t getQueueHighWaterMark() const {
+        return queue.getHighWaterMark();
+    }
+
+    void resetQueueHighWaterMark() {
+        queue.resetHighWaterMark();
+    }
+
 private:
     /**
      * States
@@ -110,7 +124,7 @@ private:
     uint8_t NR;
     uint8_t totalNBs;
     AckLayer::done_callback_t doneCallback;
-    DSMEQueue<IDSMEMessage*, CAP_QUEUE_SIZE> queue;
+    DSMEQueue<IDSMEMessage*> queue;
 };
 
 } /* namespace dsme */
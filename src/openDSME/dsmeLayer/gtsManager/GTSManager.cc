@@ -229,7 +229,8 @@ fsmReturnStatus GTSManager::stateIdle(GTSEvent& event) {
 
         case GTSEvent::CFP_STARTED: {
             // check if a slot should be deallocated, only if no reply or notify is pending
-            for(DSMEAllocationCounterTable::iterator it = dsme.getMAC_PIB().macDSMEACT.begin(); it != dsme.getMAC_PIB().macDSMEACT.end(); ++it) {
+            DSMEAllocationCounterTable& act = dsme.getMAC_PIB().macDSMEACT;
+            for(DSMEAllocationCounterTable::iterator it = act.beginDeallocationCandidates(); it != act.end(); ++it) {
                 // Since no reply is pending, this slot should have been removed already and is no longer in the ACT
                 // This should be even the case for timeouts (NO_DATA indication for upper layer)
                 DSME_ASSERT(it->getState() != DEALLOCATED);
@@ -237,11 +238,11 @@ fsmReturnStatus GTSManager::stateIdle(GTSEvent& event) {
 
                 LOG_DEBUG("check slot " << (uint16_t)it->getGTSlotID() << " " << it->getSuperframeID() << " " << (uint16_t)it->getChannel() << " ["
                                         << this->dsme.getMAC_PIB().macShortAddress << (const char*)((it->getDirection() == Direction::TX) ? ">" : "<")
-                                        << it->getAddress() << ", " << it->getIdleCounter() << "]");
+                                        << it->getAddress() << ", " << act.getIdleCounter(it) << "]");
 
                 // TODO Since INVALID is not included in the standard, use the EXPIRATION type for INVALID, too.
                 //      The effect should be the same.
-                if(it->getState() == INVALID || it->getState() == UNCONFIRMED || it->getIdleCounter() > dsme.getMAC_PIB().macDSMEGTSExpirationTime) {
+                if(it->getState() == INVALID || it->getState() == UNCONFIRMED || act.getIdleCounter(it) > dsme.getMAC_PIB().macDSMEGTSExpirationTime) {
                     if(it->getState() == INVALID) {
                         LOG_INFO("DEALLOCATE: Due to state INVALID");
                     } else if(it->getState() == UNCONFIRMED) {
@@ -249,8 +250,8 @@ fsmReturnStatus GTSManager::stateIdle(GTSEvent& event) {
                             continue;
                         }
                         LOG_INFO("DEALLOCATE: Due to state UNCONFIRMED");
-                    } else if(it->getIdleCounter() > dsme.getMAC_PIB().macDSMEGTSExpirationTime) {
-                        it->resetIdleCounter();
+                    } else if(act.getIdleCounter(it) > dsme.getMAC_PIB().macDSMEGTSExpirationTime) {
+                        act.resetIdleCounter(it);
                         LOG_INFO("DEALLOCATE: Due to expiration");
                     } else {
                         DSME_ASSERT(false);
@@ -272,6 +273,8 @@ fsmReturnStatus GTSManager::stateIdle(GTSEvent& event) {
 
                     this->dsme.getMLME_SAP().getDSME_GTS().notify_indication(params);
                     break;
+                } else {
+                    act.dropDeallocationCandidate(it);
                 }
             }
 
@@ -453,14 +456,13 @@ fsmReturnStatus GTSManager::stateWaitForResponse(GTSEvent& event) {
 
             if(event.management.status == GTSStatus::SUCCESS) {
                 if(event.management.type == ALLOCATION) {
-                    if(checkAndHandleGTSDuplicateAllocation(event.replyNotifyCmd.getSABSpec(), event.deviceAddr, true)) { // TODO issue #3
-                        uint8_t numSlotsOk = event.replyNotifyCmd.getSABSpec().getSubBlock().count(true);
+                    /* '-> duplicates are removed from the SAB, the remaining slots of a multi-slot reply are still accepted */
+                    checkAndHandleGTSDuplicateAllocation(event.replyNotifyCmd.getSABSpec(), event.deviceAddr, true); // TODO issue #3
+                    params.dsmeSabSpecification = event.replyNotifyCmd.getSABSpec();
 
-                        if(numSlotsOk == 0) {
-                            event.management.status = GTSStatus::DENIED;
-                        } else {
-                            DSME_ASSERT(false); /* This case is not handled properly, better use only one slot per request */
-                        }
+                    if(event.replyNotifyCmd.getSABSpec().getSubBlock().count(true) == 0) {
+                        event.management.status = GTSStatus::DENIED;
+                        params.status = GTSStatus::DENIED;
                     } else {
                         actUpdater.approvalReceived(event.replyNotifyCmd.getSABSpec(), event.management, event.deviceAddr,
                                                     event.replyNotifyCmd.getChannelOffset());
@@ -679,17 +681,23 @@ void GTSManager::actionReportBusyCommStatus(GTSEvent& event) {
  *****************************/
 
 bool GTSManager::handleMLMERequest(uint16_t deviceAddr, GTSManagement& man, GTSRequestCmd& cmd) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_GTS_MANAGER);
+
     int8_t fsmId = getFsmIdForRequest();
     return dispatch(fsmId, GTSEvent::MLME_REQUEST_ISSUED, deviceAddr, man, cmd);
 }
 
 bool GTSManager::handleMLMEResponse(GTSManagement& man, GTSReplyNotifyCmd& reply) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_GTS_MANAGER);
+
     uint16_t destinationAddress = reply.getDestinationAddress();
     int8_t fsmId = getFsmIdForResponse(destinationAddress);
     return dispatch(fsmId, GTSEvent::MLME_RESPONSE_ISSUED, destinationAddress, man, reply);
 }
 
 bool GTSManager::handleGTSRequest(IDSMEMessage* msg) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_GTS_MANAGER);
+
     // This can be directly passed to the upper layer.
     // There is no need to go over the state machine!
     uint16_t sourceAddr = msg->getHeader().getSrcAddr().getShortAddress();
@@ -718,6 +726,8 @@ bool GTSManager::handleGTSRequest(IDSMEMessage* msg) {
 }
 
 bool GTSManager::handleGTSResponse(IDSMEMessage* msg) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_GTS_MANAGER);
+
     GTSManagement management;
     GTSReplyNotifyCmd replyNotifyCmd;
     management.decapsulateFrom(msg);
@@ -748,6 +758,8 @@ bool GTSManager::handleGTSResponse(IDSMEMessage* msg) {
 }
 
 bool GTSManager::handleGTSNotify(IDSMEMessage* msg) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_GTS_MANAGER);
+
     GTSManagement management;
 
     management.decapsulateFrom(msg);
@@ -779,18 +791,17 @@ bool GTSManager::handleGTSNotify(IDSMEMessage* msg) {
 }
 
 bool GTSManager::handleStartOfCFP(uint8_t superframe) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_GTS_MANAGER);
+
     for(uint8_t i = 0; i < GTS_STATE_MULTIPLICITY; ++i) {
         data[i].superframesInCurrentState++;
     }
 
     // also execute this during non-idle phases
     if(superframe == 0) {
-        for(DSMEAllocationCounterTable::iterator it = dsme.getMAC_PIB().macDSMEACT.begin(); it != dsme.getMAC_PIB().macDSMEACT.end(); ++it) {
-            if(it->getDirection() == Direction::RX) {
-                // New multi-superframe started, so increment the idle counter according to 5.1.10.5.3
-                it->incrementIdleCounter(); // gets reset to zero on RX
-            }
-        }
+        // New multi-superframe started, so increment the idle counters of the RX slots according to 5.1.10.5.3
+        // This is done lazily by the ACT, the counters get reset to zero on RX
+        dsme.getMAC_PIB().macDSMEACT.startMultiSuperframe();
     }
 
     for(uint8_t i = 0; i < GTS_STATE_MULTIPLICITY; ++i) {
@@ -808,6 +819,8 @@ bool GTSManager::handleStartOfCFP(uint8_t superframe) {
 }
 
 bool GTSManager::onCSMASent(IDSMEMessage* msg, CommandFrameIdentifier cmdId, DataStatus::Data_Status status, uint8_t numBackoffs) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_GTS_MANAGER);
+
     GTSManagement management;
     management.decapsulateFrom(msg);
 
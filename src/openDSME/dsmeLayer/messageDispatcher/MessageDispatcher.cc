@@ -60,6 +60,7 @@
 #include "../../mac_services/pib/MAC_PIB.h"
 #include "../../mac_services/pib/PHY_PIB.h"
 #include "../../mac_services/pib/PIBHelper.h"
+#include "../DSMEEventDispatcher.h"
 #include "../DSMELayer.h"
 #include "../ackLayer/AckLayer.h"
 #include "../associationManager/AssociationManager.h"
@@ -77,22 +78,26 @@ namespace dsme {
 
 MessageDispatcher::MessageDispatcher(DSMELayer& dsme)
     : dsme(dsme),
-      currentACTElement(nullptr, nullptr),
+      currentACTElement(nullptr, ACT_INVALID_POSITION),
       doneGTS(DELEGATE(&MessageDispatcher::sendDoneGTS, *this)),
       dsmeAckFrame(nullptr),
       lastSendGTSNeighbor(neighborQueue.end()) {
 }
 
 MessageDispatcher::~MessageDispatcher() {
-    for(NeighborQueue<MAX_NEIGHBORS>::iterator it = neighborQueue.begin(); it != neighborQueue.end(); ++it) {
+    for(NeighborQueue::iterator it = neighborQueue.begin(); it != neighborQueue.end(); ++it) {
         while(!this->neighborQueue.isQueueEmpty(it)) {
             IDSMEMessage* msg = neighborQueue.popFront(it);
             this->dsme.getPlatform().releaseMessage(msg);
         }
     }
+    delete[] this->expiredMessages;
 }
 
 void MessageDispatcher::initialize(void) {
+    neighborQueue.initialize(dsme.getMAC_PIB().macMaxNeighbors, dsme.getMAC_PIB().macGTSQueueSize, dsme.getMAC_PIB().macGTSQueueEDF,
+                             dsme.getMAC_PIB().macGTSQueueGuaranteed);
+    expiredMessages = new IDSMEMessage*[dsme.getMAC_PIB().macGTSQueueSize];
     currentACTElement = dsme.getMAC_PIB().macDSMEACT.end();
     return;
 }
@@ -100,30 +105,45 @@ void MessageDispatcher::initialize(void) {
 void MessageDispatcher::reset(void) {
     currentACTElement = dsme.getMAC_PIB().macDSMEACT.end();
 
-    for(NeighborQueue<MAX_NEIGHBORS>::iterator it = neighborQueue.begin(); it != neighborQueue.end(); ++it) {
+    if(this->numGTSAggregatedMessages > 0) {
+        /* '-> the ACK layer did not return the aggregate, so the packed messages are confirmed here */
+        this->dsme.getPlatform().releaseMessage(this->gtsAggregateInFlight);
+        this->gtsAggregateInFlight = nullptr;
+        for(uint8_t i = 0; i < this->numGTSAggregatedMessages; i++) {
+            IDSMEMessage* msg = this->gtsAggregatedMessages[i];
+            neighborQueue.remove(this->lastSendGTSNeighbor, msg);
+            confirmDroppedGTSMessage(msg, DataStatus::TRANSACTION_EXPIRED);
+        }
+        this->numGTSAggregatedMessages = 0;
+    }
+
+    for(NeighborQueue::iterator it = neighborQueue.begin(); it != neighborQueue.end(); ++it) {
         while(!this->neighborQueue.isQueueEmpty(it)) {
             IDSMEMessage* msg = neighborQueue.popFront(it);
-            mcps_sap::DATA_confirm_parameters params;
-            params.msduHandle = msg;
-            params.timestamp = 0;
-            params.rangingReceived = false;
-            params.gtsTX = true;
-            params.status = DataStatus::TRANSACTION_EXPIRED;
-            params.numBackoffs = 0;
-            this->dsme.getMCPS_SAP().getDATA().notify_confirm(params);
+            confirmDroppedGTSMessage(msg, DataStatus::TRANSACTION_EXPIRED);
         }
     }
     while(this->neighborQueue.getNumNeighbors() > 0) {
-        NeighborQueue<MAX_NEIGHBORS>::iterator it = this->neighborQueue.begin();
+        NeighborQueue::iterator it = this->neighborQueue.begin();
         this->neighborQueue.eraseNeighbor(it);
     }
+    this->lastSendGTSNeighbor = this->neighborQueue.end();
+    this->gtsMessageInFlight = nullptr;
+    this->numFramesInCurrentGTS = 0;
+    this->expiryCheckScheduled = false;
 
     return;
 }
 
 void MessageDispatcher::finalizeGTSTransmission() {
+    if(this->numFramesInCurrentGTS > 0) {
+        this->dsme.getPlatform().signalGTSFramesPerSlot(this->numFramesInCurrentGTS);
+        this->numFramesInCurrentGTS = 0;
+    }
+
     transceiverOffIfAssociated();
     this->lastSendGTSNeighbor = this->neighborQueue.end();
+    this->gtsMessageInFlight = nullptr;
     this->currentACTElement = this->dsme.getMAC_PIB().macDSMEACT.end();
 }
 
@@ -135,7 +155,66 @@ void MessageDispatcher::transceiverOffIfAssociated() {
     }
 }
 
+void MessageDispatcher::addNeighbor(const IEEE802154MacAddress& address) {
+    if(this->neighborQueue.getNumNeighbors() >= this->neighborQueue.getMaxNeighbors()) {
+        /* '-> make room for the new neighbor */
+        evictIdleNeighbors();
+    }
+
+    Neighbor n(address);
+    this->neighborQueue.addNeighbor(n);
+
+    NeighborQueue::iterator it = this->neighborQueue.findByAddress(address);
+    if(it != this->neighborQueue.end()) {
+        it->lastActivity = this->dsme.getPlatform().getSymbolCounter();
+    } else {
+        LOG_INFO("NeighborQueue is full, " << address.getShortAddress() << " not added.");
+    }
+}
+
+void MessageDispatcher::handleStartOfCFP(uint8_t superframe) {
+    if(superframe == 0) {
+        /* '-> once per multi-superframe */
+        evictIdleNeighbors();
+        signalQueueOccupancy();
+    }
+}
+
+void MessageDispatcher::signalQueueOccupancy() {
+    IDSMEPlatform& platform = this->dsme.getPlatform();
+
+    CAPLayer& capLayer = this->dsme.getCapLayer();
+    platform.signalQueueOccupancy(CAP_QUEUE, capLayer.getQueueSize(), capLayer.getQueueHighWaterMark());
+    capLayer.resetQueueHighWaterMark();
+
+    platform.signalQueueOccupancy(GTS_QUEUE, this->neighborQueue.getQueueSize(), this->neighborQueue.getQueueHighWaterMark());
+    this->neighborQueue.resetQueueHighWaterMark();
+}
+
+void MessageDispatcher::evictIdleNeighbors() {
+    uint32_t idleTimeout = this->dsme.getMAC_PIB().macNeighborIdleTimeout;
+    if(idleTimeout == 0 || this->lastSendGTSNeighbor != this->neighborQueue.end()) {
+        /* '-> disabled, or the iterator of the current transmission must stay valid */
+        return;
+    }
+
+    uint32_t now = this->dsme.getPlatform().getSymbolCounter();
+    DSMEAllocationCounterTable& act = this->dsme.getMAC_PIB().macDSMEACT;
+    neighbor_size_t numEvicted = this->neighborQueue.eraseNeighborsIf([&](const NeighborListEntry<IDSMEMessage>& neighbor) {
+        uint16_t address = neighbor.address.getShortAddress();
+        return neighbor.queueSize == 0 && now - neighbor.lastActivity >= idleTimeout && act.getNumAllocatedGTS(address, TX) == 0 &&
+               act.getNumAllocatedGTS(address, RX) == 0;
+    });
+
+    if(numEvicted > 0) {
+        LOG_INFO("Evicted " << numEvicted << " idle neighbors from the NeighborQueue.");
+        this->numEvictedNeighbors += numEvicted;
+    }
+}
+
 bool MessageDispatcher::handlePreSlotEvent(uint8_t nextSlot, uint8_t nextSuperframe, uint8_t nextMultiSuperframe) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_MESSAGE_DISPATCHER);
+
     // Prepare next slot
     // Switch to next slot channel and radio mode
 
@@ -197,6 +276,7 @@ bool MessageDispatcher::handlePreSlotEvent(uint8_t nextSlot, uint8_t nextSuperfr
             // statistic
             if(this->currentACTElement->getDirection() == RX) {
                 this->numUnusedRxGts++; // gets PURGE.cc decremented on actual reception
+                this->receivedInCurrentGTS = false;
             }
         } else {
             /* '-> nothing to do during this slot */
@@ -224,6 +304,10 @@ bool MessageDispatcher::handlePreSlotEvent(uint8_t nextSlot, uint8_t nextSuperfr
 }
 
 bool MessageDispatcher::handleSlotEvent(uint8_t slot, uint8_t superframe, int32_t lateness) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_MESSAGE_DISPATCHER);
+
+    checkExpiredMessages();
+
     if(slot > dsme.getMAC_PIB().helper.getFinalCAPSlot(superframe)) {
         handleGTS(lateness);
     }
@@ -231,6 +315,8 @@ bool MessageDispatcher::handleSlotEvent(uint8_t slot, uint8_t superframe, int32_
 }
 
 void MessageDispatcher::receive(IDSMEMessage* msg) {
+    DSME_PROFILE(this->dsme.getProfiler(), PROFILE_MESSAGE_DISPATCHER);
+
     IEEE802154eMACHeader macHdr = msg->getHeader();
 
     switch(macHdr.getFrameType()) {
@@ -334,7 +420,7 @@ void MessageDispatcher::createDataIndication(IDSMEMessage* msg) {
     this->dsme.getMCPS_SAP().getDATA().notify_indication(params);
 }
 
-bool MessageDispatcher::sendInGTS(IDSMEMessage* msg, NeighborQueue<MAX_NEIGHBORS>::iterator destIt) {
+bool MessageDispatcher::sendInGTS(IDSMEMessage* msg, NeighborQueue::iterator destIt) {
     DSME_ASSERT(!msg->getHeader().getDestAddr().isBroadcast());
     DSME_ASSERT(this->dsme.getMAC_PIB().macAssociatedPANCoord);
     DSME_ASSERT(destIt != neighborQueue.end());
@@ -342,27 +428,165 @@ bool MessageDispatcher::sendInGTS(IDSMEMessage* msg, NeighborQueue<MAX_NEIGHBORS
     numUpperPacketsForGTS++;
 
 #if (ENABLE_SECURITY_ALL == 1)
-    msg = EncryptFrame(msg);
+    {
+        DSME_PROFILE(this->dsme.getProfiler(), PROFILE_SECURITY);
+        msg = EncryptFrame(msg);
+    }
 #endif
 
-    if(!neighborQueue.isQueueFull()) {
-        /* push into queue */
-        // TODO implement TRANSACTION_EXPIRED
-        uint16_t totalSize = 0;
-        for(NeighborQueue<MAX_NEIGHBORS>::iterator it = neighborQueue.begin(); it != neighborQueue.end(); ++it) {
-            totalSize += it->queueSize;
+    msg->enqueueSymbolCounter = this->dsme.getPlatform().getSymbolCounter();
+
+    uint32_t persistence = this->dsme.getMAC_PIB().helper.getTransactionPersistenceSymbols();
+    if(persistence > 0) {
+        /* '-> a deadline of the upper layer is kept if it is earlier */
+        uint32_t persistenceEnd = msg->enqueueSymbolCounter + persistence;
+        if(!msg->hasExpiry || static_cast<int32_t>(persistenceEnd - msg->expirySymbolCounter) < 0) {
+            msg->expirySymbolCounter = persistenceEnd;
+            msg->hasExpiry = true;
+        }
+    }
+
+    if(this->dsme.getMAC_PIB().macGTSQueueDropPolicy == SOJOURN_TIME && isSojournTimeExceeded(msg, destIt)) {
+        /* '-> standing queue for this neighbor */
+        LOG_INFO("NeighborQueue sojourn time exceeded for " << destIt->address.getShortAddress() << "!");
+        numUpperPacketsDroppedSojournTime++;
+        return false;
+    }
+
+    if(!neighborQueue.hasRoomFor(destIt) && this->dsme.getMAC_PIB().macGTSQueueDropPolicy == HEAD_DROP) {
+        /* '-> make room by dropping the oldest message of this neighbor, but never a more urgent one */
+        IDSMEMessage* dropped = neighborQueue.dropHead(destIt, msg->priorityClass, gtsMessageInFlight);
+        if(dropped != nullptr) {
+            LOG_INFO("NeighborQueue quota exhausted for " << destIt->address.getShortAddress() << ", dropping head.");
+            numUpperPacketsDroppedFullQueue++;
+            confirmDroppedGTSMessage(dropped, DataStatus::TRANSACTION_OVERFLOW);
         }
-        LOG_INFO("NeighborQueue is at " << totalSize << "/" << TOTAL_GTS_QUEUE_SIZE << ".");
+    }
+
+    if(neighborQueue.hasRoomFor(destIt)) {
+        /* push into queue */
+        LOG_INFO("NeighborQueue is at " << neighborQueue.getQueueSize() << "/" << neighborQueue.getQueueCapacity() << ".");
         neighborQueue.pushBack(destIt, msg);
+        destIt->lastActivity = msg->enqueueSymbolCounter;
+        if(msg->hasExpiry) {
+            scheduleExpiryCheck(msg->expirySymbolCounter);
+        }
         return true;
     } else {
-        /* queue full */
+        /* queue full or quota of the neighbor exhausted */
         LOG_INFO("NeighborQueue is full!");
         numUpperPacketsDroppedFullQueue++;
         return false;
     }
 }
 
+bool MessageDispatcher::isSojournTimeExceeded(IDSMEMessage* msg, NeighborQueue::iterator& destIt) {
+    const MAC_PIB& pib = this->dsme.getMAC_PIB();
+    uint32_t now = msg->enqueueSymbolCounter;
+
+    /* the oldest message of the class is the one waiting longest */
+    IDSMEMessage* head = neighborQueue.front(destIt, msg->priorityClass);
+    if(head == nullptr || now - head->enqueueSymbolCounter < pib.macGTSQueueSojournTarget) {
+        /* '-> queue drains fast enough */
+        destIt->sojournAboveTarget = false;
+        return false;
+    }
+
+    if(!destIt->sojournAboveTarget) {
+        /* '-> give the queue one interval to drain before the first drop */
+        destIt->sojournAboveTarget = true;
+        destIt->sojournNextDrop = now + pib.macGTSQueueSojournInterval;
+        return false;
+    }
+
+    if(static_cast<int32_t>(now - destIt->sojournNextDrop) < 0) {
+        return false;
+    }
+
+    destIt->sojournNextDrop = now + pib.macGTSQueueSojournInterval;
+    return true;
+}
+
+void MessageDispatcher::confirmDroppedGTSMessage(IDSMEMessage* msg, DataStatus::Data_Status status) {
+    mcps_sap::DATA_confirm_parameters params;
+    params.msduHandle = msg;
+    params.timestamp = 0;
+    params.rangingReceived = false;
+    params.gtsTX = true;
+    params.status = status;
+    params.numBackoffs = 0;
+    this->dsme.getMCPS_SAP().getDATA().notify_confirm(params);
+}
+
+void MessageDispatcher::purgeExpiredFront(NeighborQueue::iterator& neighbor) {
+    uint32_t now = this->dsme.getPlatform().getSymbolCounter();
+
+    IDSMEMessage* msg;
+    while((msg = neighborQueue.front(neighbor)) != nullptr && isExpired(msg, now)) {
+        DSME_ASSERT(!isInTransmission(msg));
+        LOG_INFO("Message for " << neighbor->address.getShortAddress() << " expired in NeighborQueue.");
+        neighborQueue.popFront(neighbor, msg);
+        numUpperPacketsDroppedExpired++;
+        confirmDroppedGTSMessage(msg, DataStatus::TRANSACTION_EXPIRED);
+    }
+}
+
+void MessageDispatcher::checkExpiredMessages() {
+    uint32_t now = this->dsme.getPlatform().getSymbolCounter();
+    if(!this->expiryCheckScheduled || static_cast<int32_t>(now - this->nextExpiryCheck) < 0) {
+        /* '-> nothing can have expired yet */
+        return;
+    }
+
+    /* the earliest remaining expiry is collected on the way */
+    this->expiryCheckScheduled = false;
+    auto expiredOrSchedule = [this, now](IDSMEMessage* msg) {
+        if(!msg->hasExpiry || isInTransmission(msg)) {
+            /* '-> a message in transmission is scheduled again in sendDoneGTS if it stays queued */
+            return false;
+        } else if(isExpired(msg, now)) {
+            return true;
+        }
+        scheduleExpiryCheck(msg->expirySymbolCounter);
+        return false;
+    };
+
+    queue_size_t maxExpired = this->dsme.getMAC_PIB().macGTSQueueSize;
+    queue_size_t numExpired = 0;
+    for(NeighborQueue::iterator it = neighborQueue.begin(); it != neighborQueue.end(); ++it) {
+        queue_size_t numRemoved = neighborQueue.removeIf(it, expiredOrSchedule, this->expiredMessages + numExpired, maxExpired - numExpired);
+        if(numRemoved > 0) {
+            LOG_INFO(numRemoved << " messages for " << it->address.getShortAddress() << " expired in NeighborQueue.");
+        }
+        numExpired += numRemoved;
+    }
+
+    /* confirmed only now, as the upper layer might queue new messages in the callback */
+    numUpperPacketsDroppedExpired += numExpired;
+    for(queue_size_t i = 0; i < numExpired; i++) {
+        confirmDroppedGTSMessage(this->expiredMessages[i], DataStatus::TRANSACTION_EXPIRED);
+    }
+}
+
+void MessageDispatcher::scheduleExpiryCheck(uint32_t expirySymbolCounter) {
+    if(!this->expiryCheckScheduled || static_cast<int32_t>(expirySymbolCounter - this->nextExpiryCheck) < 0) {
+        this->nextExpiryCheck = expirySymbolCounter;
+        this->expiryCheckScheduled = true;
+    }
+}
+
+bool MessageDispatcher::isInTransmission(const IDSMEMessage* msg) const {
+    if(msg == this->gtsMessageInFlight) {
+        return true;
+    }
+    for(uint8_t i = 0; i < this->numGTSAggregatedMessages; i++) {
+        if(msg == this->gtsAggregatedMessages[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool MessageDispatcher::sendInCAP(IDSMEMessage* msg) {
     numUpperPacketsForCAP++;
     LOG_INFO("Inserting message into CAP queue.");
@@ -397,10 +621,15 @@ void MessageDispatcher::handleGTS(int32_t lateness) {
 
             IEEE802154MacAddress adr = IEEE802154MacAddress(this->currentACTElement->getAddress());
             this->lastSendGTSNeighbor = this->neighborQueue.findByAddress(IEEE802154MacAddress(this->currentACTElement->getAddress()));
+            if(this->lastSendGTSNeighbor == this->neighborQueue.end() && this->dsme.getMAC_PIB().macNeighborIdleTimeout > 0) {
+                /* '-> evicted while the slot was being allocated, nothing can be queued for it */
+                addNeighbor(adr);
+                this->lastSendGTSNeighbor = this->neighborQueue.findByAddress(adr);
+            }
             if(this->lastSendGTSNeighbor == this->neighborQueue.end()) {
                 /* '-> the neighbor associated with the current slot does not exist */
 
-                LOG_ERROR("neighborQueue.size: " << ((uint8_t) this->neighborQueue.getNumNeighbors()));
+                LOG_ERROR("neighborQueue.size: " << this->neighborQueue.getNumNeighbors());
                 LOG_ERROR("neighbor address: " << HEXOUT << adr.a1() << ":" << adr.a2() << ":" << adr.a3() << ":" << adr.a4() << DECOUT);
                 for(auto it : this->neighborQueue) {
                     LOG_ERROR("neighbor address: " << HEXOUT << it.address.a1() << ":" << it.address.a2() << ":" << it.address.a3() << ":" << it.address.a4()
@@ -409,31 +638,25 @@ void MessageDispatcher::handleGTS(int32_t lateness) {
                 DSME_ASSERT(false);
             }
 
+            purgeExpiredFront(this->lastSendGTSNeighbor);
+
             if(this->neighborQueue.isQueueEmpty(this->lastSendGTSNeighbor)) {
                 /* '-> no message to be sent */
                 finalizeGTSTransmission();
                 this->numUnusedTxGts++;
+            } else if(isHeldForAggregation(this->lastSendGTSNeighbor)) {
+                /* '-> a single message waits for further messages to be packed with */
+                finalizeGTSTransmission();
+                this->numUnusedTxGts++;
             } else {
                 /* '-> a message is queued for transmission */
 
                 IDSMEMessage* msg = neighborQueue.front(this->lastSendGTSNeighbor);
+                this->gtsSlotStartSymbolCounter = this->dsme.getPlatform().getSymbolCounter() - lateness;
 #if 1
-                DSME_ASSERT(this->dsme.getMAC_PIB().helper.getSymbolsPerSlot() >= lateness + msg->getTotalSymbols() +
-                                                                                      this->dsme.getMAC_PIB().helper.getAckWaitDuration() +
-                                                                                      10 /* arbitrary processing delay */ + PRE_EVENT_SHIFT);
+                DSME_ASSERT(fitsIntoCurrentGTS(msg, lateness));
 #endif
-                bool result = this->dsme.getAckLayer().prepareSendingCopy(msg, this->doneGTS);
-                if(result) {
-                    /* '-> ACK-layer was ready, send message now
-                     * sendDoneGTS might have already been called, then sendNowIfPending does nothing! */
-                    this->dsme.getAckLayer().sendNowIfPending();
-                } else {
-                    /* '-> message could not be sent -> probably currently receiving external interference */
-                    sendDoneGTS(AckLayerResponse::SEND_FAILED, msg);
-                }
-
-                // statistics
-                this->numTxGtsFrames++;
+                sendGTSFrame(msg, lateness);
             }
         } else {
             finalizeGTSTransmission();
@@ -441,21 +664,143 @@ void MessageDispatcher::handleGTS(int32_t lateness) {
     }
 }
 
+bool MessageDispatcher::fitsIntoCurrentGTS(IDSMEMessage* msg, uint32_t symbolsSinceSlotStart) {
+    const PIBHelper& helper = this->dsme.getMAC_PIB().helper;
+    return helper.getSymbolsPerSlot() >=
+           symbolsSinceSlotStart + msg->getTotalSymbols() + helper.getAckWaitDuration() + 10 /* arbitrary processing delay */ + PRE_EVENT_SHIFT;
+}
+
+void MessageDispatcher::sendGTSFrame(IDSMEMessage* msg, uint32_t symbolsSinceSlotStart) {
+    this->gtsMessageInFlight = msg;
+    IDSMEMessage* frame = aggregateGTSFrame(msg, symbolsSinceSlotStart);
+
+    // statistics, counted before sendDoneGTS might finalize the slot
+    this->numTxGtsFrames++;
+    this->numFramesInCurrentGTS++;
+
+    bool result = this->dsme.getAckLayer().prepareSendingCopy(frame, this->doneGTS);
+    if(result) {
+        /* '-> ACK-layer was ready, send message now
+         * sendDoneGTS might have already been called, then sendNowIfPending does nothing! */
+        this->dsme.getAckLayer().sendNowIfPending();
+    } else {
+        /* '-> message could not be sent -> probably currently receiving external interference */
+        sendDoneGTS(AckLayerResponse::SEND_FAILED, frame);
+    }
+}
+
+IDSMEMessage* MessageDispatcher::aggregateGTSFrame(IDSMEMessage* msg, uint32_t symbolsSinceSlotStart) {
+    DSME_ASSERT(this->numGTSAggregatedMessages == 0);
+
+    uint8_t maxBytes = this->dsme.getMAC_PIB().macMaxAggregateSize;
+    if(maxBytes == 0) {
+        return msg;
+    }
+
+    /* only the following messages of the same class, so that no other message can be dropped or inserted in front of them */
+    IDSMEMessage* candidates[MAX_AGGREGATED_MESSAGES];
+    uint8_t numCandidates = neighborQueue.peek(this->lastSendGTSNeighbor, msg->priorityClass, candidates, MAX_AGGREGATED_MESSAGES);
+    DSME_ASSERT(numCandidates > 0 && candidates[0] == msg);
+
+    /* expired messages are not sent, they are dropped by the next expiry check */
+    uint32_t now = this->dsme.getPlatform().getSymbolCounter();
+    for(uint8_t i = 1; i < numCandidates; i++) {
+        if(isExpired(candidates[i], now)) {
+            numCandidates = i;
+            break;
+        }
+    }
+    if(numCandidates < 2) {
+        return msg;
+    }
+
+    uint8_t numAggregated = 0;
+    IDSMEMessage* aggregate = this->dsme.getPlatform().createAggregate(candidates, numCandidates, maxBytes, numAggregated);
+    if(aggregate == nullptr) {
+        return msg;
+    } else if(!fitsIntoCurrentGTS(aggregate, symbolsSinceSlotStart)) {
+        /* '-> the slot is too short for the larger frame */
+        this->dsme.getPlatform().releaseMessage(aggregate);
+        return msg;
+    }
+
+    DSME_ASSERT(numAggregated >= 2 && numAggregated <= numCandidates);
+    for(uint8_t i = 0; i < numAggregated; i++) {
+        this->gtsAggregatedMessages[i] = candidates[i];
+    }
+    this->numGTSAggregatedMessages = numAggregated;
+    this->gtsAggregateInFlight = aggregate;
+
+    // statistics
+    this->numTxAggregates++;
+    this->numAggregatedMessages += numAggregated;
+    return aggregate;
+}
+
+bool MessageDispatcher::isHeldForAggregation(NeighborQueue::iterator& neighbor) {
+    const MAC_PIB& pib = this->dsme.getMAC_PIB();
+    if(pib.macMaxAggregateSize == 0 || pib.macAggregationDelayBudget == 0 || neighborQueue.getPacketsInQueue(neighbor) != 1) {
+        return false;
+    }
+
+    IDSMEMessage* msg = neighborQueue.front(neighbor);
+    return msg->getRetryCounter() == 0 && this->dsme.getPlatform().getSymbolCounter() - msg->enqueueSymbolCounter < pib.macAggregationDelayBudget;
+}
+
+bool MessageDispatcher::prepareNextGTSFrame() {
+    if(!this->dsme.getMAC_PIB().macMultipleFramesPerGTS || this->currentACTElement == this->dsme.getMAC_PIB().macDSMEACT.end() ||
+       this->lastSendGTSNeighbor == this->neighborQueue.end() || this->neighborQueue.isQueueEmpty(this->lastSendGTSNeighbor)) {
+        return false;
+    }
+
+    /* the ACK layer is still busy with the previous frame, continue after the interframe spacing */
+    uint32_t nextFrameTime = this->dsme.getPlatform().getSymbolCounter() + const_redefines::macLIFSPeriod;
+    if(!fitsIntoCurrentGTS(neighborQueue.front(this->lastSendGTSNeighbor), nextFrameTime - this->gtsSlotStartSymbolCounter)) {
+        return false;
+    }
+
+    this->dsme.getEventDispatcher().setupGTSFrameTimer(nextFrameTime);
+    return true;
+}
+
+void MessageDispatcher::handleGTSFrameTimer() {
+    if(this->currentACTElement == this->dsme.getMAC_PIB().macDSMEACT.end() || this->lastSendGTSNeighbor == this->neighborQueue.end()) {
+        /* '-> reset in the meantime */
+        return;
+    }
+
+    /* the queue might have changed since the timer was set up */
+    purgeExpiredFront(this->lastSendGTSNeighbor);
+    IDSMEMessage* msg = neighborQueue.front(this->lastSendGTSNeighbor);
+    if(msg != nullptr && fitsIntoCurrentGTS(msg, this->dsme.getPlatform().getSymbolCounter() - this->gtsSlotStartSymbolCounter)) {
+        sendGTSFrame(msg, this->dsme.getPlatform().getSymbolCounter() - this->gtsSlotStartSymbolCounter);
+    } else {
+        finalizeGTSTransmission();
+    }
+}
+
 void MessageDispatcher::handleGTSFrame(IDSMEMessage* msg) {
     DSME_ASSERT(currentACTElement != dsme.getMAC_PIB().macDSMEACT.end());
 
     numRxGtsFrames++;
-    numUnusedRxGts--;
+    if(!receivedInCurrentGTS) {
+        /* '-> with several frames per GTS, only the first one marks the slot as used */
+        receivedInCurrentGTS = true;
+        numUnusedRxGts--;
+    }
 
 #if (ENABLE_SECURITY_ALL == 1)
     bool isAuthenticated;
-    msg = DecryptFrame(msg, &isAuthenticated);
+    {
+        DSME_PROFILE(this->dsme.getProfiler(), PROFILE_SECURITY);
+        msg = DecryptFrame(msg, &isAuthenticated);
+    }
 #endif
 
     if(currentACTElement->getSuperframeID() == dsme.getCurrentSuperframe() &&
        currentACTElement->getGTSlotID() == dsme.getCurrentSlot() - (dsme.getMAC_PIB().helper.getFinalCAPSlot(dsme.getCurrentSuperframe()) + 1)) {
         // According to 5.1.10.5.3
-        currentACTElement->resetIdleCounter();
+        dsme.getMAC_PIB().macDSMEACT.resetIdleCounter(currentACTElement);
     }
 
     createDataIndication(msg);
@@ -519,20 +864,43 @@ void MessageDispatcher::sendDoneGTS(enum AckLayerResponse response, IDSMEMessage
     LOG_DEBUG("sendDoneGTS");
 
     DSME_ASSERT(lastSendGTSNeighbor != neighborQueue.end());
-    DSME_ASSERT(msg == neighborQueue.front(lastSendGTSNeighbor));
 
     DSMEAllocationCounterTable& act = this->dsme.getMAC_PIB().macDSMEACT;
     DSME_ASSERT(this->currentACTElement != act.end());
 
+    IDSMEMessage* aggregate = nullptr;
+    if(this->numGTSAggregatedMessages > 0) {
+        /* '-> msg packs several queued messages, the first of them carries the retry state */
+        aggregate = msg;
+        msg = this->gtsAggregatedMessages[0];
+    }
+
     if(response != AckLayerResponse::NO_ACK_REQUESTED && response != AckLayerResponse::ACK_SUCCESSFUL) {
-        currentACTElement->incrementIdleCounter();
+        act.incrementIdleCounter(currentACTElement);
 
         // not successful -> retry?
         if(msg->getRetryCounter() < dsme.getMAC_PIB().macMaxFrameRetries) {
             msg->increaseRetryCounter();
+
+            /* the messages stay queued, but were skipped by checkExpiredMessages during the transmission */
+            if(msg->hasExpiry) {
+                scheduleExpiryCheck(msg->expirySymbolCounter);
+            }
+            for(uint8_t i = 1; i < this->numGTSAggregatedMessages; i++) {
+                if(this->gtsAggregatedMessages[i]->hasExpiry) {
+                    scheduleExpiryCheck(this->gtsAggregatedMessages[i]->expirySymbolCounter);
+                }
+            }
+
+            if(aggregate != nullptr) {
+                /* '-> packed again for the next try */
+                this->numGTSAggregatedMessages = 0;
+                this->gtsAggregateInFlight = nullptr;
+                this->dsme.getPlatform().releaseMessage(aggregate);
+            }
             finalizeGTSTransmission();
             LOG_DEBUG("sendDoneGTS - retry");
-            return; // will stay at front of queue
+            return; // will stay at front of its class
         }
     }
 
@@ -541,8 +909,13 @@ void MessageDispatcher::sendDoneGTS(enum AckLayerResponse response, IDSMEMessage
                                                                msg->getHeader().getDestAddr());
     }
 
-    neighborQueue.popFront(lastSendGTSNeighbor);
-    lastSendGTSNeighbor = neighborQueue.end();
+    /* a more urgent message might have been queued during the transmission */
+    neighborQueue.popFront(lastSendGTSNeighbor, msg);
+    lastSendGTSNeighbor->lastActivity = this->dsme.getPlatform().getSymbolCounter();
+    for(uint8_t i = 1; i < this->numGTSAggregatedMessages; i++) {
+        neighborQueue.remove(lastSendGTSNeighbor, this->gtsAggregatedMessages[i]);
+    }
+    gtsMessageInFlight = nullptr;
 
     mcps_sap::DATA_confirm_parameters params;
     params.msduHandle = msg;
@@ -557,14 +930,14 @@ void MessageDispatcher::sendDoneGTS(enum AckLayerResponse response, IDSMEMessage
             params.status = DataStatus::SUCCESS;
             break;
         case AckLayerResponse::ACK_FAILED:
-            DSME_ASSERT(this->currentACTElement != this->dsme.getMAC_PIB().macDSMEACT.end());
-            currentACTElement->incrementIdleCounter();
+            DSME_ASSERT(this->currentACTElement != act.end());
+            act.incrementIdleCounter(currentACTElement);
             params.status = DataStatus::NO_ACK;
             break;
         case AckLayerResponse::SEND_FAILED:
             LOG_DEBUG("SEND_FAILED during GTS");
-            DSME_ASSERT(this->currentACTElement != this->dsme.getMAC_PIB().macDSMEACT.end());
-            currentACTElement->incrementIdleCounter();
+            DSME_ASSERT(this->currentACTElement != act.end());
+            act.incrementIdleCounter(currentACTElement);
             params.status = DataStatus::CHANNEL_ACCESS_FAILURE;
             break;
         case AckLayerResponse::SEND_ABORTED:
@@ -576,7 +949,24 @@ void MessageDispatcher::sendDoneGTS(enum AckLayerResponse response, IDSMEMessage
     }
 
     params.numBackoffs = 0;
-    this->dsme.getMCPS_SAP().getDATA().notify_confirm(params);
+    if(aggregate == nullptr) {
+        this->dsme.getMCPS_SAP().getDATA().notify_confirm(params);
+    } else {
+        /* '-> every packed message is confirmed on its own */
+        uint8_t numMessages = this->numGTSAggregatedMessages;
+        this->numGTSAggregatedMessages = 0;
+        this->gtsAggregateInFlight = nullptr;
+        this->dsme.getPlatform().releaseMessage(aggregate);
+        for(uint8_t i = 0; i < numMessages; i++) {
+            params.msduHandle = this->gtsAggregatedMessages[i];
+            this->dsme.getMCPS_SAP().getDATA().notify_confirm(params);
+        }
+    }
+
+    if(params.status == DataStatus::SUCCESS && prepareNextGTSFrame()) {
+        /* '-> slot continues with the next frame */
+        return;
+    }
     finalizeGTSTransmission();
 }
 
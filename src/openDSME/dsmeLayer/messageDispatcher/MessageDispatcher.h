@@ -72,20 +72,20 @@ public:
      */
     void onCSMASent(IDSMEMessage* msg, DataStatus::Data_Status status, uint8_t numBackoffs, uint8_t transmissionAttempts);
 
-    bool sendInGTS(IDSMEMessage* msg, NeighborQueue<MAX_NEIGHBORS>::iterator destIt);
+    bool sendInGTS(IDSMEMessage* msg, NeighborQueue::iterator destIt);
 
     bool sendInCAP(IDSMEMessage* msg);
 
     void receive(IDSMEMessage* msg);
 
-    NeighborQueue<MAX_NEIGHBORS>& getNeighborQueue() {
+    NeighborQueue& getNeighborQueue() {
         return neighborQueue;
     }
 
-    void addNeighbor(const IEEE802154MacAddress& address) {
-        Neighbor n(address);
-        neighborQueue.addNeighbor(n);
-    }
+    /**
+     * Adds a neighbor, idle neighbors are evicted first if there is no room left.
+     */
+    void addNeighbor(const IEEE802154MacAddress& address);
 
     bool neighborExists(const IEEE802154MacAddress& address) {
         return neighborQueue.findByAddress(address) != neighborQueue.end();
@@ -95,6 +95,14 @@ public:
         return numUpperPacketsDroppedFullQueue;
     }
 
+    long getNumUpperPacketsDroppedSojournTime() const {
+        return numUpperPacketsDroppedSojournTime;
+    }
+
+    long getNumUpperPacketsDroppedExpired() const {
+        return numUpperPacketsDroppedExpired;
+    }
+
     long getNumUpperPacketsForCAP() const {
         return numUpperPacketsForCAP;
     }
@@ -103,6 +111,25 @@ public:
         return numUpperPacketsForGTS;
     }
 
+    long getNumTxAggregates() const {
+        return numTxAggregates;
+    }
+
+    long getNumAggregatedMessages() const {
+        return numAggregatedMessages;
+    }
+
+    long getNumEvictedNeighbors() const {
+        return numEvictedNeighbors;
+    }
+
+    /**
+     * This shall be called at the start of every CFP.
+     *
+     * @param superframe The current superframe number
+     */
+    void handleStartOfCFP(uint8_t superframe);
+
     /**
      * This shall be called shortly before the start of every slot to allow for setting up the transceiver.
      *
@@ -124,6 +151,11 @@ public:
      */
     bool handleSlotEvent(uint8_t slot, uint8_t superframe, int32_t lateness);
 
+    /**
+     * This shall be called when the next frame of a TX GTS is due, see prepareNextGTSFrame.
+     */
+    void handleGTSFrameTimer();
+
 protected:
     DSMEAllocationCounterTable::iterator currentACTElement;
 
@@ -142,6 +174,35 @@ protected:
      */
     void handleGTSFrame(IDSMEMessage*);
 
+    /**
+     * Checks if msg and its ACK fit into the rest of the current GTS.
+     */
+    bool fitsIntoCurrentGTS(IDSMEMessage* msg, uint32_t symbolsSinceSlotStart);
+
+    /**
+     * Hands the message, possibly packed with its successors, to the ACK layer, sendDoneGTS is called when done.
+     */
+    void sendGTSFrame(IDSMEMessage* msg, uint32_t symbolsSinceSlotStart);
+
+    /**
+     * Packs msg and the following messages of its class into one frame if aggregation is enabled.
+     *
+     * @return the aggregate, or msg if nothing was packed
+     */
+    IDSMEMessage* aggregateGTSFrame(IDSMEMessage* msg, uint32_t symbolsSinceSlotStart);
+
+    /**
+     * Checks if the only queued message of a neighbor is still within the aggregation delay budget.
+     */
+    bool isHeldForAggregation(NeighborQueue::iterator& neighbor);
+
+    /**
+     * Schedules the transmission of the next queued frame in the current GTS if enabled and if it fits.
+     *
+     * @return false if the slot is finished
+     */
+    bool prepareNextGTSFrame();
+
     long numTxGtsFrames = 0;
     long numRxAckFrames = 0;
     long numRxGtsFrames = 0;
@@ -149,16 +210,87 @@ protected:
     long numUnusedRxGts = 0;
 
     long numUpperPacketsDroppedFullQueue = 0;
+    long numUpperPacketsDroppedSojournTime = 0;
+    long numUpperPacketsDroppedExpired = 0;
     long numUpperPacketsForCAP = 0;
     long numUpperPacketsForGTS = 0;
+    long numTxAggregates = 0;
+    long numAggregatedMessages = 0;
+    long numEvictedNeighbors = 0;
 
     bool recordGtsUpdates = false;
 
-    NeighborQueue<MAX_NEIGHBORS> neighborQueue;
-    NeighborQueue<MAX_NEIGHBORS>::iterator lastSendGTSNeighbor;
+    NeighborQueue neighborQueue;
+    NeighborQueue::iterator lastSendGTSNeighbor;
+
+    /* message handed to the ACK layer in the current GTS, must stay in the queue until sendDoneGTS */
+    IDSMEMessage* gtsMessageInFlight{nullptr};
+
+    uint32_t gtsSlotStartSymbolCounter{0};
+    uint8_t numFramesInCurrentGTS{0};
+
+    /* a frame was received in the current RX GTS, so the slot no longer counts as unused */
+    bool receivedInCurrentGTS{false};
+
+    /* queued messages packed into the frame in transmission, the first is gtsMessageInFlight */
+    IDSMEMessage* gtsAggregatedMessages[MAX_AGGREGATED_MESSAGES];
+    uint8_t numGTSAggregatedMessages{0};
+    IDSMEMessage* gtsAggregateInFlight{nullptr};
+
+    /* no queued message expires before nextExpiryCheck, only valid if expiryCheckScheduled */
+    uint32_t nextExpiryCheck{0};
+    bool expiryCheckScheduled{false};
+
+    /* collects the expired messages of a check, so they are only confirmed once all queues were scanned */
+    IDSMEMessage** expiredMessages{nullptr};
 
     void createDataIndication(IDSMEMessage* msg);
 
+    /**
+     * Checks if the class of msg has been waiting longer than the sojourn target for a whole interval, msg is dropped then.
+     */
+    bool isSojournTimeExceeded(IDSMEMessage* msg, NeighborQueue::iterator& destIt);
+
+    /**
+     * Sends the MCPS-DATA.confirm for a message that leaves the GTS queue without being transmitted.
+     */
+    void confirmDroppedGTSMessage(IDSMEMessage* msg, DataStatus::Data_Status status);
+
+    /**
+     * Drops the expired messages at the front of the queue of a neighbor, so the next message to be sent is still valid.
+     */
+    void purgeExpiredFront(NeighborQueue::iterator& neighbor);
+
+    /**
+     * Drops all expired messages that are not in transmission once the earliest expiry is due.
+     * The messages in transmission are skipped, their expiry is scheduled again in sendDoneGTS.
+     * -> time: O(1) before, O(number of queued messages) afterwards
+     */
+    void checkExpiredMessages();
+
+    /**
+     * Makes sure checkExpiredMessages runs no later than the given expiry.
+     */
+    void scheduleExpiryCheck(uint32_t expirySymbolCounter);
+
+    bool isInTransmission(const IDSMEMessage* msg) const;
+
+    static bool isExpired(const IDSMEMessage* msg, uint32_t now) {
+        /* the symbol counter wraps, so compare the signed difference */
+        return msg->hasExpiry && static_cast<int32_t>(now - msg->expirySymbolCounter) >= 0;
+    }
+
+    /**
+     * Removes the neighbors that were idle for macNeighborIdleTimeout and have neither queued messages nor allocated slots.
+     * -> time: O(number of neighbors)
+     */
+    void evictIdleNeighbors();
+
+    /**
+     * Reports the occupancy and high-water marks of the CAP and GTS queues to the platform and restarts the high-water marks.
+     */
+    void signalQueueOccupancy();
+
     void finalizeGTSTransmission();
     void transceiverOffIfAssociated();
 };
@@ -53,68 +53,118 @@ namespace dsme {
 
 /* TYPES *********************************************************************/
 
-typedef uint8_t queue_size_t;
+typedef uint16_t queue_size_t;
 
 /* CLASSES *******************************************************************/
 
 /**
- * A queue for a fixed maximum number of messages for different neighbors
+ * A queue for a maximum number of messages for different neighbors
+ * The messages of a neighbor are kept in one list per priority class, the front of a neighbor is the front of its highest non-empty class.
+ * The entries are allocated once in initialize(), the capacity is fixed afterwards.
  * @template-param T type of nodes to store
- * @template-param S size of allocated chunk
  */
-template <typename T, uint8_t S>
+template <typename T>
 class MultiMessageQueue {
-private:
-    /**
-     * Represents one memory chunk to store a fixed number of messages
-     * @template-param T type of nodes to store
-     * @template-param S size of allocated chunk
-     */
-    struct Chunk {
-        Chunk() {
-            /* link all free slots inside the new chunk */
-            for(uint8_t i = 0; i < S - 1; i++) {
-                data[i].next = &(data[i + 1]);
-            }
-        }
-
-        /* Every chunk stores 'S' messages of type 'T' */
-        MessageQueueEntry<T> data[S];
-    };
-
 public:
     MultiMessageQueue();
     MultiMessageQueue(const MultiMessageQueue&) = delete;
+    MultiMessageQueue& operator=(const MultiMessageQueue&) = delete;
 
     virtual ~MultiMessageQueue();
 
     /**
-     * Adds a new message to the queue of a neighbor
+     * Allocates the entries of the queue, has to be called exactly once before the first push_back
+     * @param capacity maximum number of messages over all neighbors
+     */
+    void initialize(queue_size_t capacity);
+
+    /**
+     * Adds a new message to the back of a class of a neighbor
      * -> time: O(1)
      * @param neighbor the neighbor the message belongs to
      * @param msg pointer to the message, ownership STAYS with caller
+     * @param priorityClass class of the message, < NUM_PRIORITY_CLASSES
      */
-    void push_back(NeighborListEntry<T>& neighbor, T* msg);
+    void push_back(NeighborListEntry<T>& neighbor, T* msg, uint8_t priorityClass = 0);
 
     /**
-     * Gets and removes the first (oldest) element of the queue of a neighbor, nullptr if not existent
+     * Adds a new message to a class of a neighbor in front of the first message it is ordered before.
+     * The front of the class is never displaced, as it might currently be in transmission.
+     * -> time: O(number of messages in the class)
+     * @param neighbor the neighbor the message belongs to
+     * @param msg pointer to the message, ownership STAYS with caller
+     * @param priorityClass class of the message, < NUM_PRIORITY_CLASSES
+     * @param before returns true if the first argument has to be sent before the second
+     */
+    template <typename Compare>
+    void insert(NeighborListEntry<T>& neighbor, T* msg, uint8_t priorityClass, Compare before);
+
+    /**
+     * Gets and removes the first element of the highest class of a neighbor, nullptr if not existent
      * -> time: O(1)
      * @param neighbor the neighbor the message belongs to
      */
     T* pop_front(NeighborListEntry<T>& neighbor);
 
     /**
-     * Gets the first (oldest) element of the queue of a neighbor, nullptr if not existent
+     * Gets and removes the first element of a class of a neighbor, nullptr if not existent
+     * -> time: O(1)
+     * @param neighbor the neighbor the message belongs to
+     * @param priorityClass class of the message
+     */
+    T* pop_front(NeighborListEntry<T>& neighbor, uint8_t priorityClass);
+
+    /**
+     * Gets the first element of the highest class of a neighbor, nullptr if not existent
      * -> time: O(1)
      * @param neighbor the neighbor the message belongs to
      */
     T* front(const NeighborListEntry<T>& neighbor);
 
     /**
-     * Deletes all [but first] messages from the queue of a neighbor
+     * Gets the first element of a class of a neighbor, nullptr if not existent
+     * -> time: O(1)
+     * @param neighbor the neighbor the message belongs to
+     * @param priorityClass class of the message
+     */
+    T* front(const NeighborListEntry<T>& neighbor, uint8_t priorityClass);
+
+    /**
+     * Gets the first messages of a class of a neighbor in sending order
+     * -> time: O(maxMessages)
+     * @param neighbor the neighbor the messages belong to
+     * @param priorityClass class of the messages
+     * @param msgs array for at least maxMessages messages
+     * @return number of messages written to msgs
+     */
+    uint8_t peek(const NeighborListEntry<T>& neighbor, uint8_t priorityClass, T** msgs, uint8_t maxMessages);
+
+    /**
+     * Removes all messages of a neighbor that a predicate holds for in a single pass
+     * -> time: O(neighbor->queueSize)
+     * @param neighbor the neighbor the messages belong to
+     * @param pred returns true for the messages to remove, called once per message
+     * @param removed array for at least maxRemoved messages, receives the removed messages
+     * @return number of messages written to removed, no further messages are removed once maxRemoved is reached
+     */
+    template <typename Predicate>
+    queue_size_t remove_if(NeighborListEntry<T>& neighbor, Predicate pred, T** removed, queue_size_t maxRemoved);
+
+    /**
+     * Removes a message from a class of a neighbor
+     * -> time: O(1) for the front, otherwise O(position in the class)
+     * @param neighbor the neighbor the message belongs to
+     * @param msg the message to remove
+     * @param priorityClass class of the message
+     * @return false if the message is not queued in the class
+     */
+    bool remove(NeighborListEntry<T>& neighbor, T* msg, uint8_t priorityClass);
+
+    /**
+     * Deletes all [but the first of each class] messages from the queue of a neighbor
      * -> time: O(neighbor->queueSize)
      * @param neighbor the neighbor the messages belong to
-     * @param if true, first message is preserved
+     * @param if true, the first message of each class is preserved
      */
     void flush(NeighborListEntry<T>& neighbor, bool keepFront);
 
@@ -122,8 +172,35 @@ public:
         return full;
     }
 
+    queue_size_t getCapacity() const {
+        return capacity;
+    }
+
+    queue_size_t getSize() const {
+        return size;
+    }
+
+    /* maximum of getSize() since the last resetHighWaterMark() */
+    queue_size_t getHighWaterMark() const {
+        return highWaterMark;
+    }
+
+    void resetHighWaterMark() {
+        highWaterMark = size;
+    }
+
+    uint32_t getAllocatedMemory() const {
+        return capacity * sizeof(MessageQueueEntry<T>);
+    }
+
 private:
-    Chunk chunk;
+    /* all entries of the queue, linked either into the free list or into the list of a neighbor */
+    MessageQueueEntry<T>* entries;
+    queue_size_t capacity;
+
+    /* number of messages over all neighbors */
+    queue_size_t size;
+    queue_size_t highWaterMark;
 
     /* flag, set if queue is full */
     bool full;
@@ -131,68 +208,119 @@ private:
     MessageQueueEntry<T>* freeFront;
     MessageQueueEntry<T>* freeBack;
 
+    inline MessageQueueEntry<T>* takeFromFree(T* msg);
     inline void addToFree(MessageQueueEntry<T>* entry);
+
+    static inline uint8_t highestClass(const NeighborListEntry<T>& neighbor);
 };
 
 /* FUNCTION DEFINITIONS ******************************************************/
 
-template <typename T, uint8_t S>
-MultiMessageQueue<T, S>::MultiMessageQueue() : full(false) {
-    this->freeFront = &(this->chunk.data[0]);
-    this->freeBack = &(this->chunk.data[S - 1]);
+template <typename T>
+MultiMessageQueue<T>::MultiMessageQueue() : entries(nullptr), capacity(0), size(0), highWaterMark(0), full(true), freeFront(nullptr), freeBack(nullptr) {
 }
 
-template <typename T, uint8_t S>
-MultiMessageQueue<T, S>::~MultiMessageQueue() {
+template <typename T>
+MultiMessageQueue<T>::~MultiMessageQueue() {
+    delete[] this->entries;
+}
+
+template <typename T>
+void MultiMessageQueue<T>::initialize(queue_size_t capacity) {
+    DSME_ASSERT(this->entries == nullptr);
+    DSME_ASSERT(capacity > 0);
+
+    this->entries = new MessageQueueEntry<T>[capacity];
+    this->capacity = capacity;
+
+    /* link all free slots */
+    for(queue_size_t i = 0; i < capacity - 1; i++) {
+        this->entries[i].next = &(this->entries[i + 1]);
+    }
+    this->freeFront = &(this->entries[0]);
+    this->freeBack = &(this->entries[capacity - 1]);
+    this->full = false;
 }
 
-template <typename T, uint8_t S>
-void MultiMessageQueue<T, S>::push_back(NeighborListEntry<T>& neighbor, T* msg) {
+template <typename T>
+void MultiMessageQueue<T>::push_back(NeighborListEntry<T>& neighbor, T* msg, uint8_t priorityClass) {
+    DSME_ASSERT(priorityClass < NUM_PRIORITY_CLASSES);
+
     if(this->full) {
         /* '-> all slots are used */
         DSME_ASSERT(false);
         return;
     }
 
-    MessageQueueEntry<T>* entry = this->freeFront;
+    MessageQueueEntry<T>* entry = takeFromFree(msg);
 
-    if(this->freeFront == this->freeBack) {
-        /* '-> this was the last free spot */
-        this->freeFront = nullptr;
-        this->freeBack = nullptr;
-        this->full = true;
-    } else {
-        /* '-> still multiple empty spots left */
-        this->freeFront = this->freeFront->next;
+    if(neighbor.messageBack[priorityClass] != nullptr) {
+        neighbor.messageBack[priorityClass]->next = entry;
     }
+    neighbor.messageBack[priorityClass] = entry;
 
-    entry->value = msg;
-    entry->next = nullptr;
+    if(neighbor.messageFront[priorityClass] == nullptr) {
+        neighbor.messageFront[priorityClass] = entry;
+        neighbor.nonEmptyClasses |= (1 << priorityClass);
+    }
+
+    neighbor.queueSize++;
+}
+
+template <typename T>
+template <typename Compare>
+void MultiMessageQueue<T>::insert(NeighborListEntry<T>& neighbor, T* msg, uint8_t priorityClass, Compare before) {
+    DSME_ASSERT(priorityClass < NUM_PRIORITY_CLASSES);
 
-    if(neighbor.messageBack != nullptr) {
-        neighbor.messageBack->next = entry;
+    MessageQueueEntry<T>* previous = neighbor.messageFront[priorityClass];
+    if(previous == neighbor.messageBack[priorityClass] || !before(msg, neighbor.messageBack[priorityClass]->value)) {
+        /* '-> at most the front in this class or message belongs to the back */
+        push_back(neighbor, msg, priorityClass);
+        return;
     }
-    neighbor.messageBack = entry;
 
-    if(neighbor.messageFront == nullptr) {
-        neighbor.messageFront = neighbor.messageBack;
+    if(this->full) {
+        /* '-> all slots are used */
+        DSME_ASSERT(false);
+        return;
     }
 
+    /* the back is ordered after msg, so the search stops before the end of the list */
+    while(!before(msg, previous->next->value)) {
+        previous = previous->next;
+    }
+
+    MessageQueueEntry<T>* entry = takeFromFree(msg);
+    entry->next = previous->next;
+    previous->next = entry;
+
     neighbor.queueSize++;
 }
 
-template <typename T, uint8_t S>
-T* MultiMessageQueue<T, S>::pop_front(NeighborListEntry<T>& neighbor) {
+template <typename T>
+T* MultiMessageQueue<T>::pop_front(NeighborListEntry<T>& neighbor) {
     if(neighbor.queueSize > 0) {
-        /* '-> queue contains messages for this neighbor */
+        return pop_front(neighbor, highestClass(neighbor));
+    } else {
+        /* '-> no messages pending for this neighbor */
+        return nullptr;
+    }
+}
+
+template <typename T>
+T* MultiMessageQueue<T>::pop_front(NeighborListEntry<T>& neighbor, uint8_t priorityClass) {
+    DSME_ASSERT(priorityClass < NUM_PRIORITY_CLASSES);
 
-        MessageQueueEntry<T>* entry = neighbor.messageFront;
+    MessageQueueEntry<T>* entry = neighbor.messageFront[priorityClass];
+    if(entry != nullptr) {
+        /* '-> class contains messages for this neighbor */
         T* msg = entry->value;
 
-        neighbor.messageFront = entry->next;
+        neighbor.messageFront[priorityClass] = entry->next;
 
-        if(neighbor.messageFront == nullptr) {
-            neighbor.messageBack = nullptr;
+        if(neighbor.messageFront[priorityClass] == nullptr) {
+            neighbor.messageBack[priorityClass] = nullptr;
+            neighbor.nonEmptyClasses &= ~(1 << priorityClass);
         }
 
         this->addToFree(entry);
@@ -201,62 +329,174 @@ T* MultiMessageQueue<T, S>::pop_front(NeighborListEntry<T>& neighbor) {
         this->full = false;
         return msg;
     } else {
-        /* '-> no messages pending for this neighbor */
+        /* '-> no messages of this class pending for this neighbor */
         return nullptr;
     }
 }
 
-template <typename T, uint8_t S>
-T* MultiMessageQueue<T, S>::front(const NeighborListEntry<T>& neighbor) {
-    return (neighbor.messageFront != nullptr) ? neighbor.messageFront->value : nullptr;
+template <typename T>
+T* MultiMessageQueue<T>::front(const NeighborListEntry<T>& neighbor) {
+    return (neighbor.queueSize > 0) ? front(neighbor, highestClass(neighbor)) : nullptr;
 }
 
-template <typename T, uint8_t S>
-void MultiMessageQueue<T, S>::flush(NeighborListEntry<T>& neighbor, bool keepFront) {
-    MessageQueueEntry<T>* entry = neighbor.messageFront;
+template <typename T>
+T* MultiMessageQueue<T>::front(const NeighborListEntry<T>& neighbor, uint8_t priorityClass) {
+    DSME_ASSERT(priorityClass < NUM_PRIORITY_CLASSES);
+    return (neighbor.messageFront[priorityClass] != nullptr) ? neighbor.messageFront[priorityClass]->value : nullptr;
+}
 
-    if(keepFront && entry != nullptr) {
-        /* keep existing first entry */
-        MessageQueueEntry<T>* temp = entry;
-        entry = entry->next;
-        temp->next = nullptr;
+template <typename T>
+uint8_t MultiMessageQueue<T>::peek(const NeighborListEntry<T>& neighbor, uint8_t priorityClass, T** msgs, uint8_t maxMessages) {
+    DSME_ASSERT(priorityClass < NUM_PRIORITY_CLASSES);
 
-        neighbor.queueSize = 1;
-    } else {
-        /* discard first entry or list already empty */
-        neighbor.messageFront = nullptr;
-        neighbor.queueSize = 0;
+    uint8_t count = 0;
+    for(MessageQueueEntry<T>* entry = neighbor.messageFront[priorityClass]; entry != nullptr && count < maxMessages; entry = entry->next) {
+        msgs[count++] = entry->value;
     }
+    return count;
+}
 
-    if(entry != nullptr) {
-        /* '-> there are entries to be invalidated */
-        this->full = false;
-    } else {
-        /* '-> nothing to do */
-        return;
+template <typename T>
+template <typename Predicate>
+queue_size_t MultiMessageQueue<T>::remove_if(NeighborListEntry<T>& neighbor, Predicate pred, T** removed, queue_size_t maxRemoved) {
+    queue_size_t count = 0;
+    for(int8_t priorityClass = NUM_PRIORITY_CLASSES - 1; priorityClass >= 0 && count < maxRemoved; priorityClass--) {
+        MessageQueueEntry<T>* previous = nullptr;
+        MessageQueueEntry<T>* entry = neighbor.messageFront[priorityClass];
+        while(entry != nullptr && count < maxRemoved) {
+            MessageQueueEntry<T>* next = entry->next;
+            if(!pred(entry->value)) {
+                previous = entry;
+                entry = next;
+                continue;
+            }
+
+            removed[count++] = entry->value;
+            if(previous == nullptr) {
+                neighbor.messageFront[priorityClass] = next;
+            } else {
+                previous->next = next;
+            }
+            if(neighbor.messageBack[priorityClass] == entry) {
+                neighbor.messageBack[priorityClass] = previous;
+            }
+
+            this->addToFree(entry);
+
+            neighbor.queueSize--;
+            this->full = false;
+            entry = next;
+        }
+
+        if(neighbor.messageFront[priorityClass] == nullptr) {
+            neighbor.nonEmptyClasses &= ~(1 << priorityClass);
+        }
+    }
+    return count;
+}
+
+template <typename T>
+bool MultiMessageQueue<T>::remove(NeighborListEntry<T>& neighbor, T* msg, uint8_t priorityClass) {
+    DSME_ASSERT(priorityClass < NUM_PRIORITY_CLASSES);
+
+    MessageQueueEntry<T>* previous = neighbor.messageFront[priorityClass];
+    if(previous == nullptr) {
+        return false;
+    } else if(previous->value == msg) {
+        pop_front(neighbor, priorityClass);
+        return true;
+    }
+
+    while(previous->next != nullptr && previous->next->value != msg) {
+        previous = previous->next;
+    }
+    if(previous->next == nullptr) {
+        /* '-> not queued in this class */
+        return false;
+    }
+
+    MessageQueueEntry<T>* entry = previous->next;
+    previous->next = entry->next;
+    if(neighbor.messageBack[priorityClass] == entry) {
+        neighbor.messageBack[priorityClass] = previous;
     }
 
-    /*
-     * taken out of the loop for efficiency
-     */
     this->addToFree(entry);
-    entry = entry->next;
 
-    while(entry != nullptr) {
-        entry->value = nullptr;
-        this->freeBack->next = entry;
-        this->freeBack = entry;
-        entry = entry->next;
+    neighbor.queueSize--;
+    this->full = false;
+    return true;
+}
+
+template <typename T>
+void MultiMessageQueue<T>::flush(NeighborListEntry<T>& neighbor, bool keepFront) {
+    for(uint8_t priorityClass = 0; priorityClass < NUM_PRIORITY_CLASSES; priorityClass++) {
+        MessageQueueEntry<T>* entry = neighbor.messageFront[priorityClass];
+
+        if(entry == nullptr) {
+            /* '-> nothing to do */
+            continue;
+        }
+
+        if(keepFront) {
+            /* keep existing first entry */
+            MessageQueueEntry<T>* temp = entry;
+            entry = entry->next;
+            temp->next = nullptr;
+
+            neighbor.messageBack[priorityClass] = temp;
+        } else {
+            /* discard first entry */
+            neighbor.messageFront[priorityClass] = nullptr;
+            neighbor.messageBack[priorityClass] = nullptr;
+            neighbor.nonEmptyClasses &= ~(1 << priorityClass);
+        }
+
+        while(entry != nullptr) {
+            MessageQueueEntry<T>* next = entry->next;
+            this->addToFree(entry);
+            this->full = false;
+            entry = next;
+        }
     }
 
-    neighbor.messageBack = neighbor.messageFront;
+    neighbor.queueSize = 0;
+    for(uint8_t priorityClass = 0; priorityClass < NUM_PRIORITY_CLASSES; priorityClass++) {
+        if(neighbor.messageFront[priorityClass] != nullptr) {
+            neighbor.queueSize++;
+        }
+    }
     return;
 }
 
-template <typename T, uint8_t S>
-inline void MultiMessageQueue<T, S>::addToFree(MessageQueueEntry<T>* entry) {
+template <typename T>
+inline MessageQueueEntry<T>* MultiMessageQueue<T>::takeFromFree(T* msg) {
+    MessageQueueEntry<T>* entry = this->freeFront;
+
+    if(this->freeFront == this->freeBack) {
+        /* '-> this was the last free spot */
+        this->freeFront = nullptr;
+        this->freeBack = nullptr;
+        this->full = true;
+    } else {
+        /* '-> still multiple empty spots left */
+        this->freeFront = this->freeFront->next;
+    }
+
+    entry->value = msg;
+    entry->next = nullptr;
+    this->size++;
+    if(this->size > this->highWaterMark) {
+        this->highWaterMark = this->size;
+    }
+    return entry;
+}
+
+template <typename T>
+inline void MultiMessageQueue<T>::addToFree(MessageQueueEntry<T>* entry) {
     DSME_ASSERT(entry != nullptr);
     entry->value = nullptr;
+    this->size--;
 
     if(this->freeFront == nullptr || this->freeBack == nullptr) {
         DSME_ASSERT(this->freeFront == nullptr);
@@ -269,6 +509,12 @@ inline void MultiMessageQueue<T, S>::addToFree(MessageQueueEntry<T>* entry) {
     return;
 }
 
+template <typename T>
+inline uint8_t MultiMessageQueue<T>::highestClass(const NeighborListEntry<T>& neighbor) {
+    DSME_ASSERT(neighbor.nonEmptyClasses != 0);
+    return 31 - __builtin_clz(neighbor.nonEmptyClasses);
+}
+
 } /* namespace dsme */
 
 #endif /* MULTIMESSAGEQUEUE_H_ */
@@ -45,6 +45,7 @@
 
 /* INCLUDES ******************************************************************/
 
+#include "../../../dsme_settings.h"
 #include "./MultiMessageQueue.h"
 #include "./Neighbor.h"
 
@@ -52,7 +53,7 @@ namespace dsme {
 
 /* TYPES *********************************************************************/
 
-typedef uint8_t queue_size_t;
+typedef uint16_t queue_size_t;
 
 /* STRUCTS *******************************************************************/
 
@@ -62,16 +63,29 @@ public:
     explicit NeighborListEntry(Neighbor& neighbor);
     virtual ~NeighborListEntry() = default;
 
-    MessageQueueEntry<T>* messageFront;
-    MessageQueueEntry<T>* messageBack;
+    /* one list per priority class, indexed by the class */
+    MessageQueueEntry<T>* messageFront[NUM_PRIORITY_CLASSES];
+    MessageQueueEntry<T>* messageBack[NUM_PRIORITY_CLASSES];
+
+    /* bit i is set if the list of class i is not empty */
+    uint8_t nonEmptyClasses;
 
     queue_size_t queueSize;
+
+    /* state of the sojourn time drop policy */
+    bool sojournAboveTarget;
+    uint32_t sojournNextDrop;
+
+    /* symbol counter value of the last message queued for or sent to this neighbor */
+    uint32_t lastActivity;
 };
 
 /* FUNCTION DEFINITIONS ******************************************************/
 
 template <typename T>
-NeighborListEntry<T>::NeighborListEntry(Neighbor& neighbor) : Neighbor(neighbor), messageFront(nullptr), messageBack(nullptr), queueSize(0) {
+NeighborListEntry<T>::NeighborListEntry(Neighbor& neighbor) : Neighbor(neighbor), messageFront{}, messageBack{}, nonEmptyClasses(0), queueSize(0),
+      sojournAboveTarget(false), sojournNextDrop(0), lastActivity(0) {
+    static_assert(NUM_PRIORITY_CLASSES >= 1 && NUM_PRIORITY_CLASSES <= 8, "nonEmptyClasses holds one bit per class");
 }
 
 } /* namespace dsme */
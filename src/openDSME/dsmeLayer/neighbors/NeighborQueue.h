@@ -47,6 +47,7 @@
 
 #include "../../../dsme_settings.h"
 #include "../../helper/Integers.h"
+#include "../../interfaces/IDSMEMessage.h"
 #include "../../mac_services/dataStructures/RBTree.h"
 #include "../../mac_services/dataStructures/RBTreeIterator.h"
 #include "./MultiMessageQueue.h"
@@ -56,18 +57,29 @@ namespace dsme {
 
 /* TYPES *********************************************************************/
 
-typedef uint8_t neighbor_size_t;
-class IDSMEMessage;
+typedef uint16_t neighbor_size_t;
 
 /* CLASSES *******************************************************************/
 
 /*
- * @template-param N maximum number of neighbors
+ * Queues of the messages to be sent in GTS, one per neighbor.
+ * Each queue is split by IDSMEMessage::priorityClass, higher classes are always sent first.
+ * Within a class the messages are sent in order of arrival or, with EDF, in order of IDSMEMessage::deadline.
+ * Every neighbor is guaranteed a minimum number of messages, the rest of the storage is shared and can be borrowed by any neighbor.
+ * The storage for the neighbors and messages is allocated once in initialize().
  */
-template <uint8_t N>
 class NeighborQueue {
 public:
-    typedef RBTree<NeighborListEntry<IDSMEMessage>, IEEE802154MacAddress>::iterator iterator;
+    typedef RBTreeIterator<NeighborListEntry<IDSMEMessage>, IEEE802154MacAddress> iterator;
+
+    /*
+     * allocates the storage of the queue, has to be called exactly once before the first neighbor is added
+     * @param maxNeighbors maximum number of neighbors
+     * @param maxMessages maximum number of queued messages over all neighbors
+     * @param earliestDeadlineFirst order each class by deadline instead of arrival
+     * @param guaranteedPerNeighbor number of messages each neighbor can always queue, as long as the guarantees do not exceed maxMessages
+     */
+    void initialize(neighbor_size_t maxNeighbors, queue_size_t maxMessages, bool earliestDeadlineFirst, queue_size_t guaranteedPerNeighbor);
 
     iterator begin();
 
@@ -85,6 +97,15 @@ public:
      */
     void eraseNeighbor(iterator& neighbor);
 
+    /*
+     * erases all neighbors a predicate holds for, their queued messages are discarded
+     * -> time: O(number of neighbors + number of erased neighbors * log(number of neighbors))
+     * Iterators to other neighbors might be invalidated.
+     * @return number of erased neighbors
+     */
+    template <typename Predicate>
+    neighbor_size_t eraseNeighborsIf(Predicate pred);
+
     /*
      * gives the number of Neighbors
      *
@@ -92,6 +113,10 @@ public:
      */
     neighbor_size_t getNumNeighbors() const;
 
+    neighbor_size_t getMaxNeighbors() const {
+        return neighbors.getAllocator().capacity();
+    }
+
     iterator findByAddress(const IEEE802154MacAddress& address);
 
     queue_size_t getPacketsInQueue(const iterator& neighbor) const;
@@ -99,36 +124,130 @@ public:
 
     IDSMEMessage* front(iterator& neighbor);
 
+    IDSMEMessage* front(iterator& neighbor, uint8_t priorityClass);
+
     IDSMEMessage* popFront(iterator& neighbor);
 
+    /*
+     * removes a message that was returned by front() before,
+     * more urgent messages might have been queued in the meantime
+     */
+    void popFront(iterator& neighbor, IDSMEMessage* msg);
+
+    /*
+     * removes a queued message, O(1) if it is the front of its class
+     */
+    void remove(iterator& neighbor, IDSMEMessage* msg);
+
+    /*
+     * gets up to maxMessages messages of a class in sending order without removing them
+     */
+    uint8_t peek(iterator& neighbor, uint8_t priorityClass, IDSMEMessage** msgs, uint8_t maxMessages);
+
+    /*
+     * removes all messages that a predicate holds for in one pass, O(number of messages of the neighbor)
+     * @return number of removed messages written to removed, at most maxRemoved
+     */
+    template <typename Predicate>
+    queue_size_t removeIf(iterator& neighbor, Predicate pred, IDSMEMessage** removed, queue_size_t maxRemoved);
+
+    /*
+     * queues a message in its priority class, O(1) unless EDF is enabled
+     */
     void pushBack(iterator& neighbor, IDSMEMessage* msg);
 
     void flushQueues(bool keepFront);
 
+    /*
+     * checks if a message for the neighbor fits into its guaranteed part or into the shared part of the storage
+     * -> time: O(1)
+     */
+    bool hasRoomFor(const iterator& neighbor) const;
+
+    /*
+     * removes the oldest message of the lowest class up to maxClass to make room for a new one
+     * -> time: O(NUM_PRIORITY_CLASSES)
+     * @param keep message that must not be removed, e.g. because it is currently transmitted
+     * @return the removed message, nullptr if there is none
+     */
+    IDSMEMessage* dropHead(iterator& neighbor, uint8_t maxClass, const IDSMEMessage* keep);
+
     bool isQueueFull() const {
         return queue.isFull();
     }
 
+    queue_size_t getQueueCapacity() const {
+        return queue.getCapacity();
+    }
+
+    /*
+     * number of queued messages over all neighbors
+     * -> time: O(1)
+     */
+    queue_size_t getQueueSize() const {
+        return queue.getSize();
+    }
+
+    /*
+     * maximum of getQueueSize() since the last resetQueueHighWaterMark()
+     */
+    queue_size_t getQueueHighWaterMark() const {
+        return queue.getHighWaterMark();
+    }
+
+    void resetQueueHighWaterMark() {
+        queue.resetHighWaterMark();
+    }
+
+    /*
+     * number of messages that can be borrowed beyond the guarantees of the current neighbors
+     */
+    queue_size_t getSharedCapacity() const {
+        uint32_t reserved = static_cast<uint32_t>(guaranteedPerNeighbor) * neighbors.size();
+        return (reserved < queue.getCapacity()) ? queue.getCapacity() - reserved : 0;
+    }
+
+    uint32_t getAllocatedMemory() const {
+        return queue.getAllocatedMemory() + neighbors.getAllocator().getAllocatedMemory();
+    }
+
 private:
-    MultiMessageQueue<IDSMEMessage, TOTAL_GTS_QUEUE_SIZE> queue;
-    RBTree<NeighborListEntry<IDSMEMessage>, IEEE802154MacAddress> neighbors;
+    MultiMessageQueue<IDSMEMessage> queue;
+    bool earliestDeadlineFirst{false};
+
+    queue_size_t guaranteedPerNeighbor{0};
+
+    /* number of messages within the guarantees of their neighbors, all others are borrowed */
+    queue_size_t numGuaranteedInUse{0};
+
+    inline void countPopped(const NeighborListEntry<IDSMEMessage>& neighbor);
+
+    queue_size_t guaranteedPart(queue_size_t queueSize) const {
+        return (queueSize < guaranteedPerNeighbor) ? queueSize : guaranteedPerNeighbor;
+    }
+    RBTree<NeighborListEntry<IDSMEMessage>, IEEE802154MacAddress, RBRuntimeNodePool<NeighborListEntry<IDSMEMessage>, IEEE802154MacAddress>> neighbors;
 };
 
 /* FUNCTION DEFINITIONS ******************************************************/
 
-template <uint8_t N>
-typename NeighborQueue<N>::iterator NeighborQueue<N>::begin() {
+inline void NeighborQueue::initialize(neighbor_size_t maxNeighbors, queue_size_t maxMessages, bool earliestDeadlineFirst,
+                                      queue_size_t guaranteedPerNeighbor) {
+    neighbors.getAllocator().initialize(maxNeighbors);
+    queue.initialize(maxMessages);
+    this->earliestDeadlineFirst = earliestDeadlineFirst;
+    this->guaranteedPerNeighbor = guaranteedPerNeighbor;
+}
+
+inline NeighborQueue::iterator NeighborQueue::begin() {
     return neighbors.begin();
 }
 
-template <uint8_t N>
-const typename NeighborQueue<N>::iterator NeighborQueue<N>::end() const {
+inline const NeighborQueue::iterator NeighborQueue::end() const {
     return neighbors.end();
 }
 
-template <uint8_t N>
-void NeighborQueue<N>::addNeighbor(Neighbor& neighbor) {
-    if(neighbors.size() < N) {
+inline void NeighborQueue::addNeighbor(Neighbor& neighbor) {
+    if(neighbors.size() < neighbors.getAllocator().capacity()) {
         neighbors.insert(NeighborListEntry<IDSMEMessage>(neighbor), neighbor.address);
         return;
     } else {
@@ -136,27 +255,50 @@ void NeighborQueue<N>::addNeighbor(Neighbor& neighbor) {
     }
 }
 
-template <uint8_t N>
-void NeighborQueue<N>::eraseNeighbor(iterator& neighbor) {
+inline void NeighborQueue::eraseNeighbor(iterator& neighbor) {
     if(neighbor != neighbors.end()) {
+        numGuaranteedInUse -= guaranteedPart(neighbor->queueSize);
         queue.flush(*neighbor, false);
         neighbors.remove(neighbor);
     }
     return;
 }
 
-template <uint8_t N>
-neighbor_size_t NeighborQueue<N>::getNumNeighbors() const {
+template <typename Predicate>
+inline neighbor_size_t NeighborQueue::eraseNeighborsIf(Predicate pred) {
+    neighbor_size_t numErased = 0;
+    iterator it = neighbors.begin();
+    while(it != neighbors.end()) {
+        if(!pred(*it)) {
+            ++it;
+            continue;
+        }
+
+        /* removing a node might move the content of its successor, so continue by address */
+        iterator next = it;
+        ++next;
+        bool isLast = (next == neighbors.end());
+        IEEE802154MacAddress nextAddress;
+        if(!isLast) {
+            nextAddress = next->address;
+        }
+
+        eraseNeighbor(it);
+        numErased++;
+        it = isLast ? neighbors.end() : neighbors.find(nextAddress);
+    }
+    return numErased;
+}
+
+inline neighbor_size_t NeighborQueue::getNumNeighbors() const {
     return neighbors.size();
 }
 
-template <uint8_t N>
-typename NeighborQueue<N>::iterator NeighborQueue<N>::findByAddress(const IEEE802154MacAddress& address) {
+inline NeighborQueue::iterator NeighborQueue::findByAddress(const IEEE802154MacAddress& address) {
     return neighbors.find(address);
 }
 
-template <uint8_t N>
-queue_size_t NeighborQueue<N>::getPacketsInQueue(const iterator& neighbor) const {
+inline queue_size_t NeighborQueue::getPacketsInQueue(const iterator& neighbor) const {
     if(neighbor != end()) {
         return neighbor->queueSize;
     } else {
@@ -164,35 +306,105 @@ queue_size_t NeighborQueue<N>::getPacketsInQueue(const iterator& neighbor) const
     }
 }
 
-template <uint8_t N>
-bool NeighborQueue<N>::isQueueEmpty(iterator& neighbor) {
+inline bool NeighborQueue::isQueueEmpty(iterator& neighbor) {
     return (neighbor->queueSize == 0);
 }
 
-template <uint8_t N>
-IDSMEMessage* NeighborQueue<N>::front(iterator& neighbor) {
+inline IDSMEMessage* NeighborQueue::front(iterator& neighbor) {
     return queue.front(*neighbor);
 }
 
-template <uint8_t N>
-IDSMEMessage* NeighborQueue<N>::popFront(iterator& neighbor) {
-    return queue.pop_front(*neighbor);
+inline IDSMEMessage* NeighborQueue::front(iterator& neighbor, uint8_t priorityClass) {
+    return queue.front(*neighbor, priorityClass);
+}
+
+inline IDSMEMessage* NeighborQueue::popFront(iterator& neighbor) {
+    IDSMEMessage* msg = queue.pop_front(*neighbor);
+    if(msg != nullptr) {
+        countPopped(*neighbor);
+    }
+    return msg;
+}
+
+inline void NeighborQueue::popFront(iterator& neighbor, IDSMEMessage* msg) {
+    DSME_ASSERT(msg == queue.front(*neighbor, msg->priorityClass));
+    queue.pop_front(*neighbor, msg->priorityClass);
+    countPopped(*neighbor);
+    return;
+}
+
+inline void NeighborQueue::remove(iterator& neighbor, IDSMEMessage* msg) {
+    bool removed = queue.remove(*neighbor, msg, msg->priorityClass);
+    DSME_ASSERT(removed);
+    countPopped(*neighbor);
+    return;
+}
+
+inline uint8_t NeighborQueue::peek(iterator& neighbor, uint8_t priorityClass, IDSMEMessage** msgs, uint8_t maxMessages) {
+    return queue.peek(*neighbor, priorityClass, msgs, maxMessages);
 }
 
-template <uint8_t N>
-void NeighborQueue<N>::pushBack(iterator& neighbor, IDSMEMessage* msg) {
-    queue.push_back(*neighbor, msg);
+template <typename Predicate>
+inline queue_size_t NeighborQueue::removeIf(iterator& neighbor, Predicate pred, IDSMEMessage** removed, queue_size_t maxRemoved) {
+    queue_size_t queueSize = neighbor->queueSize;
+    queue_size_t count = queue.remove_if(*neighbor, pred, removed, maxRemoved);
+    numGuaranteedInUse -= guaranteedPart(queueSize) - guaranteedPart(neighbor->queueSize);
+    return count;
+}
+
+inline void NeighborQueue::pushBack(iterator& neighbor, IDSMEMessage* msg) {
+    if(earliestDeadlineFirst) {
+        /* the symbol counter wraps, so compare the signed difference */
+        queue.insert(*neighbor, msg, msg->priorityClass,
+                     [](IDSMEMessage* a, IDSMEMessage* b) { return static_cast<int32_t>(a->deadline - b->deadline) < 0; });
+    } else {
+        queue.push_back(*neighbor, msg, msg->priorityClass);
+    }
+
+    if(neighbor->queueSize <= guaranteedPerNeighbor) {
+        numGuaranteedInUse++;
+    }
     return;
 }
 
-template <uint8_t N>
-void NeighborQueue<N>::flushQueues(bool keepFront) {
+inline void NeighborQueue::flushQueues(bool keepFront) {
     for(iterator i = neighbors.begin(); i != neighbors.end(); ++i) {
+        numGuaranteedInUse -= guaranteedPart(i->queueSize);
         queue.flush(*i, keepFront);
+        numGuaranteedInUse += guaranteedPart(i->queueSize);
     }
     return;
 }
 
+inline bool NeighborQueue::hasRoomFor(const iterator& neighbor) const {
+    if(queue.isFull()) {
+        return false;
+    } else if(neighbor->queueSize < guaranteedPerNeighbor) {
+        /* '-> within the guarantee */
+        return true;
+    } else {
+        /* '-> has to borrow from the shared part */
+        return queue.getSize() - numGuaranteedInUse < getSharedCapacity();
+    }
+}
+
+inline IDSMEMessage* NeighborQueue::dropHead(iterator& neighbor, uint8_t maxClass, const IDSMEMessage* keep) {
+    for(uint8_t priorityClass = 0; priorityClass <= maxClass && priorityClass < NUM_PRIORITY_CLASSES; priorityClass++) {
+        IDSMEMessage* msg = queue.front(*neighbor, priorityClass);
+        if(msg != nullptr && msg != keep) {
+            popFront(neighbor, msg);
+            return msg;
+        }
+    }
+    return nullptr;
+}
+
+inline void NeighborQueue::countPopped(const NeighborListEntry<IDSMEMessage>& neighbor) {
+    if(neighbor.queueSize < guaranteedPerNeighbor) {
+        numGuaranteedInUse--;
+    }
+}
+
 } /* namespace dsme */
 
 #endif /* NEIGHBORQUEUE_H_ */
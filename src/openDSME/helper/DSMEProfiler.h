@@ -0,0 +1,183 @@
+/*
+ * openDSME
+ *
+ * Implementation of the Deterministic & Synchronous Multi-channel Extension (DSME)
+ * introduced in the IEEE 802.15.4e-2012 standard
+ *
+ * Authors: Florian Meier <florian.meier@tuhh.de>
+ *          Maximilian Koestler <maximilian.koestler@tuhh.de>
+ *          Sandrina Backhauss <sandrina.backhauss@tuhh.de>
+ *
+ * Based on
+ *          DSME Implementation for the INET Framework
+ *          Tobias Luebkert <tobias.luebkert@tuhh.de>
+ *
+ * Copyright (c) 2015, Institute of Telematics, Hamburg University of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef DSMEPROFILER_H_
+#define DSMEPROFILER_H_
+
+#include "../../dsme_settings.h"
+#include "./Integers.h"
+
+#ifdef DSME_PROFILING
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+namespace dsme {
+
+enum ProfilerSubsystem : uint8_t {
+    PROFILE_NONE,
+    PROFILE_DSME_LAYER,
+    PROFILE_MESSAGE_DISPATCHER,
+    PROFILE_GTS_MANAGER,
+    PROFILE_CAP_LAYER,
+    PROFILE_ACK_LAYER,
+    PROFILE_BEACON_MANAGER,
+    PROFILE_ASSOCIATION_MANAGER,
+    PROFILE_SCHEDULING,
+    PROFILE_SECURITY,
+    PROFILE_SUBSYSTEM_COUNT /* always last element */
+};
+
+/**
+ * Aggregates the number of calls and the elapsed cycles per subsystem of a single node.
+ * Nested scopes are accounted exclusively, i.e. the time spent in a nested subsystem is not counted for the enclosing one.
+ * On x86 the cycles are read via rdtsc, otherwise nanoseconds of the steady_clock are used.
+ */
+class DSMEProfiler {
+public:
+    DSMEProfiler() : current(PROFILE_NONE), lastTimestamp(0) {
+        for(uint8_t i = 0; i < PROFILE_SUBSYSTEM_COUNT; i++) {
+            this->calls[i] = 0;
+            this->cycles[i] = 0;
+        }
+    }
+
+    static inline uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    inline ProfilerSubsystem enter(ProfilerSubsystem subsystem) {
+        uint64_t timestamp = now();
+        this->cycles[this->current] += timestamp - this->lastTimestamp;
+        this->lastTimestamp = timestamp;
+
+        this->calls[subsystem]++;
+        ProfilerSubsystem parent = this->current;
+        this->current = subsystem;
+        return parent;
+    }
+
+    inline void leave(ProfilerSubsystem parent) {
+        uint64_t timestamp = now();
+        this->cycles[this->current] += timestamp - this->lastTimestamp;
+        this->lastTimestamp = timestamp;
+
+        this->current = parent;
+    }
+
+    uint64_t getCalls(ProfilerSubsystem subsystem) const {
+        return this->calls[subsystem];
+    }
+
+    uint64_t getCycles(ProfilerSubsystem subsystem) const {
+        return this->cycles[subsystem];
+    }
+
+    static const char* getName(ProfilerSubsystem subsystem) {
+        switch(subsystem) {
+            case PROFILE_DSME_LAYER:
+                return "DSMELayer";
+            case PROFILE_MESSAGE_DISPATCHER:
+                return "MessageDispatcher";
+            case PROFILE_GTS_MANAGER:
+                return "GTSManager";
+            case PROFILE_CAP_LAYER:
+                return "CAPLayer";
+            case PROFILE_ACK_LAYER:
+                return "AckLayer";
+            case PROFILE_BEACON_MANAGER:
+                return "BeaconManager";
+            case PROFILE_ASSOCIATION_MANAGER:
+                return "AssociationManager";
+            case PROFILE_SCHEDULING:
+                return "Scheduling";
+            case PROFILE_SECURITY:
+                return "Security";
+            default:
+                return "None";
+        }
+    }
+
+private:
+    ProfilerSubsystem current;
+    uint64_t lastTimestamp;
+
+    /* PROFILE_NONE collects the time outside of any scope and is never reported */
+    uint64_t calls[PROFILE_SUBSYSTEM_COUNT];
+    uint64_t cycles[PROFILE_SUBSYSTEM_COUNT];
+};
+
+class DSMEProfilerScope {
+public:
+    DSMEProfilerScope(DSMEProfiler& profiler, ProfilerSubsystem subsystem) : profiler(profiler), parent(profiler.enter(subsystem)) {
+    }
+
+    ~DSMEProfilerScope() {
+        this->profiler.leave(this->parent);
+    }
+
+    DSMEProfilerScope(const DSMEProfilerScope&) = delete;
+    DSMEProfilerScope& operator=(const DSMEProfilerScope&) = delete;
+
+private:
+    DSMEProfiler& profiler;
+    ProfilerSubsystem parent;
+};
+
+} /* namespace dsme */
+
+#define DSME_PROFILE(profiler, subsystem) dsme::DSMEProfilerScope dsmeProfilerScope_((profiler), (subsystem))
+
+#else
+
+#define DSME_PROFILE(profiler, subsystem)
+
+#endif /* DSME_PROFILING */
+
+#endif /* DSMEPROFILER_H_ */
@@ -47,23 +47,45 @@
 
 namespace dsme {
 
-template <typename C, uint16_t MAX_SIZE>
+/*
+ * FIFO queue whose storage is allocated once in initialize()
+ */
+template <typename C>
 class DSMEQueue {
 public:
-    DSMEQueue() : queue{}, next_back(0), size(0) {
+    DSMEQueue() : queue(nullptr), capacity(0), next_back(0), size(0), highWaterMark(0) {
+    }
+
+    ~DSMEQueue() {
+        delete[] queue;
+    }
+
+    DSMEQueue(const DSMEQueue&) = delete;
+    DSMEQueue& operator=(const DSMEQueue&) = delete;
+
+    // has to be called exactly once before the first push
+    void initialize(uint16_t capacity) {
+        DSME_ASSERT(queue == nullptr);
+        DSME_ASSERT(capacity > 0);
+
+        queue = new C[capacity]{};
+        this->capacity = capacity;
     }
 
     // assumes queue is not full
     void push(C& element) {
-        DSME_ASSERT(size < MAX_SIZE);
+        DSME_ASSERT(size < capacity);
 
         queue[next_back] = element;
         if(next_back == 0) {
-            next_back = MAX_SIZE - 1;
+            next_back = capacity - 1;
         } else {
             next_back--;
         }
         size++;
+        if(size > highWaterMark) {
+            highWaterMark = size;
+        }
     }
 
     // assumes queue is not empty
@@ -75,7 +97,7 @@ public:
     // assumes queue is not empty
     C& front() {
         DSME_ASSERT(size > 0);
-        return queue[(next_back + size) % MAX_SIZE];
+        return queue[(next_back + size) % capacity];
     }
 
     bool empty() const {
@@ -83,13 +105,28 @@ public:
     }
 
     bool full() const {
-        return (size >= MAX_SIZE);
+        return (size >= capacity);
+    }
+
+    uint16_t getSize() const {
+        return size;
+    }
+
+    // maximum of getSize() since the last resetHighWaterMark()
+    uint16_t getHighWaterMark() const {
+        return highWaterMark;
+    }
+
+    void resetHighWaterMark() {
+        highWaterMark = size;
     }
 
 private:
-    C queue[MAX_SIZE];
+    C* queue;
+    uint16_t capacity;
     uint16_t next_back;
     uint16_t size;
+    uint16_t highWaterMark;
 };
 
 } /* namespace dsme */
@@ -88,6 +88,23 @@ public:
     virtual uint8_t getRetryCounter() = 0;
 
     uint8_t queueAtCreation = -1;
+
+    /* retry state of the adaption layer, kept while the message is resubmitted */
+    uint32_t retryBufferSince = 0;
+    uint8_t retryBufferAttempts = 0;
+
+    /* class of the GTS queue, higher classes are sent first (< NUM_PRIORITY_CLASSES) */
+    uint8_t priorityClass = 0;
+
+    /* symbol counter value the message should be sent by, orders a class if EDF is enabled */
+    uint32_t deadline = 0;
+
+    /* symbol counter value when the message entered the GTS queue */
+    uint32_t enqueueSymbolCounter = 0;
+
+    /* symbol counter value the message is dropped at with TRANSACTION_EXPIRED if it is still queued, only valid if hasExpiry */
+    uint32_t expirySymbolCounter = 0;
+    bool hasExpiry = false;
 };
 
 } /* namespace dsme */
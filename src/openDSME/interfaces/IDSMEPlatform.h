@@ -75,11 +75,47 @@ public:
      */
     virtual void releaseMessage(IDSMEMessage* msg) = 0;
 
+    /*
+     * Packs the payloads of the leading candidates into one new data frame with the header of the first candidate.
+     * The candidates stay owned by the caller, the aggregate has to be released by the caller.
+     *
+     * @param candidates messages to the same destination in sending order
+     * @param numCandidates number of candidates, at least two
+     * @param maxBytes maximum size of the aggregate frame including MAC header and FCS
+     * @param numAggregated set to the number of leading candidates contained in the aggregate
+     * @return the aggregate or nullptr if less than two candidates fit or aggregation is not supported
+     */
+    virtual IDSMEMessage* createAggregate(IDSMEMessage* const* candidates, uint8_t numCandidates, uint8_t maxBytes, uint8_t& numAggregated) {
+        numAggregated = 0;
+        return nullptr;
+    }
+
     /*
      * Start a timer at symbolCounterValue symbols
      */
     virtual void startTimer(uint32_t symbolCounterValue) = 0;
 
+    /*
+     * Returns whether the platform provides a dedicated timer for each event type of the DSMEEventDispatcher.
+     * In that case startNativeTimer and stopNativeTimer are used instead of multiplexing all events onto startTimer
+     * and the platform has to call DSMEEventDispatcher::nativeTimerInterrupt once a timer expires.
+     */
+    virtual bool hasNativeTimers() {
+        return false;
+    }
+
+    /*
+     * Start the dedicated timer for the given event type at symbolCounterValue symbols
+     */
+    virtual void startNativeTimer(uint8_t timer, uint32_t symbolCounterValue) {
+    }
+
+    /*
+     * Stop the dedicated timer for the given event type
+     */
+    virtual void stopNativeTimer(uint8_t timer) {
+    }
+
     /*
      * Gets the current time in symbols
      */
@@ -112,11 +148,31 @@ public:
     virtual void signalAckedTransmissionResult(bool success, uint8_t transmissionAttempts, IEEE802154MacAddress receiver) {
     }
 
+    /*
+     * Signal the lateness in symbols of an event of the DSMEEventDispatcher (see EventTimers) when it is handled.
+     * Only called if STATISTICS_MONITOR_LATENESS is defined.
+     */
+    virtual void signalTimerLateness(uint8_t timer, int32_t lateness) {
+    }
+
     /*
      * Signal GTS allocation or deallocation
      */
     virtual void signalGTSChange(bool deallocation, IEEE802154MacAddress counterpart) {
     }
+
+    /*
+     * Signal the number of frames transmitted in a TX GTS that was used
+     */
+    virtual void signalGTSFramesPerSlot(uint8_t numFrames) {
+    }
+
+    /*
+     * Signal the occupancy of a queue, sampled at the start of every multi-superframe.
+     * The high-water mark is the maximum occupancy since the previous sample.
+     */
+    virtual void signalQueueOccupancy(QueueId queue, uint16_t size, uint16_t highWaterMark) {
+    }
 };
 
 } /* namespace dsme */
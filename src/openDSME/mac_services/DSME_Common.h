@@ -307,6 +307,12 @@ enum Channel_Diversity_Mode { CHANNEL_ADAPTATION = 0x00, CHANNEL_HOPPING = 0x01
 
 enum AckLayerResponse { SEND_FAILED, NO_ACK_REQUESTED, ACK_FAILED, ACK_SUCCESSFUL, SEND_ABORTED };
 
+/* what to drop if a GTS queue is over its quota, SOJOURN_TIME additionally drops arrivals while a standing queue persists */
+enum QueueDropPolicy { TAIL_DROP, HEAD_DROP, SOJOURN_TIME };
+
+/* message queues whose occupancy is reported to the platform */
+enum QueueId { CAP_QUEUE, GTS_QUEUE, RETRY_BUFFER, QUEUE_COUNT };
+
 } /* namespace dsme */
 
 #endif /* DSME_COMMON_H_ */
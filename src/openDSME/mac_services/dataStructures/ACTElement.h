@@ -51,12 +51,9 @@ enum ACTState { VALID, UNCONFIRMED, INVALID, DEALLOCATED, REMOVED };
 
 class ACTElement {
     friend class DSMEAllocationCounterTable;
+    friend class ACTIterator;
 
 public:
-    uint16_t getIdleCounter() const {
-        return idleCounter;
-    }
-
     uint16_t getAddress() const {
         return address;
     }
@@ -77,14 +74,6 @@ public:
         return direction;
     }
 
-    void incrementIdleCounter() {
-        idleCounter++;
-    }
-
-    void resetIdleCounter() {
-        idleCounter = 0;
-    }
-
     bool operator>(const ACTElement& other) const {
         if(this->superframeID > other.superframeID) {
             return true;
@@ -126,8 +115,14 @@ public:
     }
 
 private:
+    ACTElement()
+        : superframeID(0), slotID(0), channel(0), direction(TX), address(0), idleCounter(0), idleEpoch(0), state(INVALID), nextInList(0xFFFF),
+          prevInList(0xFFFF) {
+    }
+
     ACTElement(uint16_t superframeID, uint8_t slotID, uint8_t channel, Direction direction, uint16_t address, ACTState state)
-        : superframeID(superframeID), slotID(slotID), channel(channel), direction(direction), address(address), idleCounter(0), state(state) {
+        : superframeID(superframeID), slotID(slotID), channel(channel), direction(direction), address(address), idleCounter(0), idleEpoch(0), state(state),
+          nextInList(0xFFFF), prevInList(0xFFFF) {
     }
 
     uint16_t superframeID;
@@ -135,7 +130,12 @@ private:
     uint8_t channel;
     Direction direction;
     uint16_t address;
+
+    // The idle counter is evaluated lazily by the DSMEAllocationCounterTable.
+    // Failed transmissions are counted explicitly, for RX slots the multi-superframes
+    // since idleEpoch are added, so no periodic increment is required.
     uint16_t idleCounter;
+    uint32_t idleEpoch;
 
     // Slot state
     // TODO implementation specific, not handled by the standard
@@ -149,6 +149,10 @@ private:
     // since a transmission might induce collisions, but a reception could collect pending messages if
     // the slot on the other device is still VALID.
     ACTState state;
+
+    // Bitmap positions of the neighboring elements with the same address and direction, 0xFFFF marks the end of the list
+    uint16_t nextInList;
+    uint16_t prevInList;
 };
 
 } /* namespace dsme */
@@ -59,7 +59,11 @@
 using namespace dsme;
 
 DSMEAllocationCounterTable::DSMEAllocationCounterTable()
-    : numSuperFramesPerMultiSuperframe(0), numGTSlotsFirstSuperframe(0), numGTSlotsLatterSuperframes(0), numChannels(0) {
+    : numSuperFramesPerMultiSuperframe(0), numGTSlotsFirstSuperframe(0), numGTSlotsLatterSuperframes(0), numChannels(0), elements(nullptr), epoch(0) {
+}
+
+DSMEAllocationCounterTable::~DSMEAllocationCounterTable() {
+    delete[] this->elements;
 }
 
 void DSMEAllocationCounterTable::initialize(uint16_t numSuperFramesPerMultiSuperframe, uint8_t numGTSlotsFirstSuperframe, uint8_t numGTSlotsLatterSuperframes,
@@ -68,10 +72,31 @@ void DSMEAllocationCounterTable::initialize(uint16_t numSuperFramesPerMultiSuper
     this->numGTSlotsFirstSuperframe = numGTSlotsFirstSuperframe;
     this->numGTSlotsLatterSuperframes = numGTSlotsLatterSuperframes;
     this->numChannels = numChannels;
-    bitmap.initialize((numGTSlotsFirstSuperframe + (numSuperFramesPerMultiSuperframe - 1) * numGTSlotsLatterSuperframes), false);
+
+    /* '-> the node pool of the index is reallocated, so all neighbors have to be released first */
+    while(this->neighbors.size() != 0) {
+        auto it = this->neighbors.begin();
+        this->neighbors.remove(it);
+    }
+
+    uint16_t numPositions = numGTSlotsFirstSuperframe + (numSuperFramesPerMultiSuperframe - 1) * numGTSlotsLatterSuperframes;
+    if(this->elements == nullptr || numPositions != bitmap.length()) {
+        delete[] this->elements;
+        this->elements = new ACTElement[numPositions];
+    }
+    bitmap.setLength(numPositions, false);
+    neighbors.getAllocator().initialize(numPositions);
+    expiryScheduled.setLength(numPositions, false);
+    deallocationCandidates.setLength(numPositions, false);
+    expiries.setCapacity(numPositions);
     this->dsme = dsme;
 }
 
+uint32_t DSMEAllocationCounterTable::getAllocatedMemory() const {
+    return bitmap.length() * sizeof(ACTElement) + bitmap.getAllocatedMemory() + neighbors.getAllocator().getAllocatedMemory()
+           + expiries.getAllocatedMemory() + expiryScheduled.getAllocatedMemory() + deallocationCandidates.getAllocatedMemory();
+}
+
 uint16_t DSMEAllocationCounterTable::getBitmapPosition(uint8_t superframeID, uint8_t slotID) const {
     if(superframeID == 0) {
         return slotID;
@@ -81,34 +106,44 @@ uint16_t DSMEAllocationCounterTable::getBitmapPosition(uint8_t superframeID, uin
 }
 
 DSMEAllocationCounterTable::iterator DSMEAllocationCounterTable::begin() {
-    return act.begin();
+    return iterator(this, getNextPosition(0));
 }
 
 DSMEAllocationCounterTable::iterator DSMEAllocationCounterTable::end() {
-    return act.end();
+    return iterator(this, ACT_INVALID_POSITION);
 }
 
-void DSMEAllocationCounterTable::clear() {
-    while(this->act.size() != 0) {
-        auto it = this->act.begin();
-        this->act.remove(it);
+DSMEAllocationCounterTable::iterator DSMEAllocationCounterTable::begin(uint16_t address, Direction direction) {
+    neighbor_iterator neighborIt = neighbors.find(address);
+    if(neighborIt == neighbors.end()) {
+        return end();
     }
+    return begin(*neighborIt, direction);
+}
 
-    for(int i = 0; i < 2; i++) {
-        while(this->numAllocatedSlots[i].size() != 0) {
-            auto it = this->numAllocatedSlots[i].begin();
-            this->numAllocatedSlots[i].remove(it);
-        }
-    }
+DSMEAllocationCounterTable::iterator DSMEAllocationCounterTable::begin(const ACTNeighborEntry& neighbor, Direction direction) {
+    int d = (direction == TX) ? 0 : 1;
+    return iterator(this, neighbor.first[d], ACTIterator::NEIGHBOR_LIST);
+}
 
-    this->bitmap.fill(false);
+DSMEAllocationCounterTable::neighbor_iterator DSMEAllocationCounterTable::beginNeighbors() {
+    return neighbors.begin();
 }
 
-DSMEAllocationCounterTable::iterator DSMEAllocationCounterTable::find(uint16_t superframeID, uint8_t gtSlotID) {
-    ACTPosition pos;
-    pos.superframeID = superframeID;
-    pos.gtSlotID = gtSlotID;
-    return act.find(pos);
+DSMEAllocationCounterTable::neighbor_iterator DSMEAllocationCounterTable::endNeighbors() {
+    return neighbors.end();
+}
+
+void DSMEAllocationCounterTable::clear() {
+    while(this->neighbors.size() != 0) {
+        auto it = this->neighbors.begin();
+        this->neighbors.remove(it);
+    }
+
+    this->bitmap.fill(false);
+    this->expiryScheduled.fill(false);
+    this->deallocationCandidates.fill(false);
+    this->expiries.clear();
 }
 
 void DSMEAllocationCounterTable::printChange(const char* type, uint16_t superframeID, uint8_t gtSlotID, uint8_t channel, bool direction, uint16_t address) {
@@ -137,30 +172,61 @@ bool DSMEAllocationCounterTable::add(uint16_t superframeID, uint8_t gtSlotID, ui
     }
     DSME_ASSERT(!isAllocated(superframeID, gtSlotID));
 
-    ACTPosition pos;
-    pos.superframeID = superframeID;
-    pos.gtSlotID = gtSlotID;
-    bool success = act.insert(ACTElement(superframeID, gtSlotID, channel, direction, address, state), pos);
-
-    if(success) {
-        int d = (direction == TX) ? 0 : 1;
-        RBTree<uint16_t, uint16_t>::iterator numSlotIt = numAllocatedSlots[d].find(address);
-        if(numSlotIt == numAllocatedSlots[d].end()) {
-            LOG_DEBUG("Inserting 0x" << HEXOUT << address << DECOUT << " into numAllocatedSlots[" << d << ".");
-            numAllocatedSlots[d].insert(1, address);
-        } else {
-            (*numSlotIt)++;
-            LOG_DEBUG("Incrementing slot count " << d << HEXOUT << " for 0x" << address << DECOUT << " (now at " << *numSlotIt << ").");
+    uint16_t position = getBitmapPosition(superframeID, gtSlotID);
+    ACTElement& element = elements[position];
+    element = ACTElement(superframeID, gtSlotID, channel, direction, address, state);
+    element.idleEpoch = epoch;
+
+    /* insert into the list of the neighbor, which is kept sorted by the bitmap position */
+    int d = (direction == TX) ? 0 : 1;
+    neighbor_iterator neighborIt = neighbors.find(address);
+    if(neighborIt == neighbors.end()) {
+        LOG_DEBUG("Inserting 0x" << HEXOUT << address << DECOUT << " into the neighbors of the ACT.");
+        ACTNeighborEntry neighbor;
+        neighbor.address = address;
+        neighbor.numSlots[0] = 0;
+        neighbor.numSlots[1] = 0;
+        neighbor.first[0] = ACT_INVALID_POSITION;
+        neighbor.first[1] = ACT_INVALID_POSITION;
+        if(!neighbors.insert(neighbor, address)) {
+            return false;
         }
+        neighborIt = neighbors.find(address);
+    }
 
-        bitmap.set(getBitmapPosition(superframeID, gtSlotID), true);
+    uint16_t prev = ACT_INVALID_POSITION;
+    uint16_t next = neighborIt->first[d];
+    while(next != ACT_INVALID_POSITION && next < position) {
+        prev = next;
+        next = elements[next].nextInList;
     }
 
-    return success;
+    element.prevInList = prev;
+    element.nextInList = next;
+    if(prev == ACT_INVALID_POSITION) {
+        neighborIt->first[d] = position;
+    } else {
+        elements[prev].nextInList = position;
+    }
+    if(next != ACT_INVALID_POSITION) {
+        elements[next].prevInList = position;
+    }
+
+    neighborIt->numSlots[d]++;
+    LOG_DEBUG("Incrementing slot count " << d << HEXOUT << " for 0x" << address << DECOUT << " (now at " << neighborIt->numSlots[d] << ").");
+
+    bitmap.set(position, true);
+
+    if(direction == RX) {
+        scheduleExpiry(position);
+    }
+    updateDeallocationCandidate(position);
+
+    return true;
 }
 
 void DSMEAllocationCounterTable::remove(DSMEAllocationCounterTable::iterator it) {
-    DSME_ASSERT(it != act.end());
+    DSME_ASSERT(it != end());
 
     uint16_t superframeID = it->getSuperframeID();
     uint8_t gtSlotID = it->getGTSlotID();
@@ -171,18 +237,28 @@ void DSMEAllocationCounterTable::remove(DSMEAllocationCounterTable::iterator it)
 
     DSME_ASSERT(isAllocated(superframeID, gtSlotID));
 
-    bitmap.set(getBitmapPosition(superframeID, gtSlotID), false);
+    uint16_t position = getBitmapPosition(superframeID, gtSlotID);
+    bitmap.set(position, false);
+    deallocationCandidates.set(position, false);
 
     int d = (it->direction == TX) ? 0 : 1;
-    RBTree<uint16_t, uint16_t>::iterator numSlotIt = numAllocatedSlots[d].find(it->address);
-    DSME_ASSERT(numSlotIt != numAllocatedSlots[d].end());
-    (*numSlotIt)--;
-    LOG_DEBUG("Decrementing slot count for " << it->address << DECOUT << " (now at " << *numSlotIt << ").");
-    if((*numSlotIt) == 0) {
-        numAllocatedSlots[d].remove(numSlotIt);
+    neighbor_iterator neighborIt = neighbors.find(it->address);
+    DSME_ASSERT(neighborIt != neighbors.end());
+
+    if(it->prevInList == ACT_INVALID_POSITION) {
+        neighborIt->first[d] = it->nextInList;
+    } else {
+        elements[it->prevInList].nextInList = it->nextInList;
+    }
+    if(it->nextInList != ACT_INVALID_POSITION) {
+        elements[it->nextInList].prevInList = it->prevInList;
     }
 
-    act.remove(it);
+    neighborIt->numSlots[d]--;
+    LOG_DEBUG("Decrementing slot count for " << it->address << DECOUT << " (now at " << neighborIt->numSlots[d] << ").");
+    if(neighborIt->numSlots[0] == 0 && neighborIt->numSlots[1] == 0) {
+        neighbors.remove(neighborIt);
+    }
 }
 
 bool DSMEAllocationCounterTable::isAllocated(uint16_t superframeID, uint8_t gtSlotID) const {
@@ -190,13 +266,103 @@ bool DSMEAllocationCounterTable::isAllocated(uint16_t superframeID, uint8_t gtSl
     return bitmap.get(getBitmapPosition(superframeID, gtSlotID));
 }
 
+uint16_t DSMEAllocationCounterTable::getAllocatedSlots(uint16_t superframeID) const {
+    uint8_t numGTSlots = (superframeID == 0) ? numGTSlotsFirstSuperframe : numGTSlotsLatterSuperframes;
+    return bitmap.getBits(getBitmapPosition(superframeID, 0), numGTSlots);
+}
+
+void DSMEAllocationCounterTable::startMultiSuperframe() {
+    epoch++;
+
+    while(!expiries.empty() && expiries.top().epoch <= epoch) {
+        uint16_t position = expiries.top().position;
+        expiries.pop();
+        expiryScheduled.set(position, false);
+
+        if(!bitmap.get(position) || elements[position].direction != RX) {
+            /* '-> slot was removed in the meantime */
+            continue;
+        }
+
+        if(getIdleCounter(iterator(this, position)) > dsme->getMAC_PIB().macDSMEGTSExpirationTime) {
+            deallocationCandidates.set(position, true);
+        } else {
+            /* '-> slot was used in the meantime */
+            scheduleExpiry(position);
+        }
+    }
+}
+
+uint16_t DSMEAllocationCounterTable::getIdleCounter(iterator it) const {
+    uint32_t idleCounter = it->idleCounter;
+    if(it->direction == RX) {
+        idleCounter += epoch - it->idleEpoch;
+    }
+    return (idleCounter > UINT16_MAX) ? UINT16_MAX : idleCounter;
+}
+
+void DSMEAllocationCounterTable::incrementIdleCounter(iterator it) {
+    it->idleCounter++;
+    updateDeallocationCandidate(getBitmapPosition(it->superframeID, it->slotID));
+}
+
+void DSMEAllocationCounterTable::resetIdleCounter(iterator it) {
+    it->idleCounter = 0;
+    it->idleEpoch = epoch;
+    if(it->direction == RX) {
+        scheduleExpiry(getBitmapPosition(it->superframeID, it->slotID));
+    }
+}
+
+DSMEAllocationCounterTable::iterator DSMEAllocationCounterTable::beginDeallocationCandidates() {
+    uint16_t position = deallocationCandidates.findNext(0, true);
+    if(position == deallocationCandidates.length()) {
+        return end();
+    }
+    return iterator(this, position, ACTIterator::DEALLOCATION_CANDIDATES);
+}
+
+void DSMEAllocationCounterTable::dropDeallocationCandidate(iterator it) {
+    deallocationCandidates.set(getBitmapPosition(it->superframeID, it->slotID), false);
+}
+
+void DSMEAllocationCounterTable::scheduleExpiry(uint16_t position) {
+    if(expiryScheduled.get(position)) {
+        /* '-> the existing entry is checked again when it expires */
+        return;
+    }
+
+    const ACTElement& element = elements[position];
+    uint8_t expirationTime = dsme->getMAC_PIB().macDSMEGTSExpirationTime;
+
+    ACTExpiry expiry;
+    expiry.position = position;
+    if(element.idleCounter > expirationTime) {
+        expiry.epoch = epoch;
+    } else {
+        expiry.epoch = element.idleEpoch + (expirationTime - element.idleCounter) + 1;
+    }
+
+    bool pushed = expiries.push(expiry);
+    DSME_ASSERT(pushed);
+    expiryScheduled.set(position, true);
+}
+
+void DSMEAllocationCounterTable::updateDeallocationCandidate(uint16_t position) {
+    ACTElement& element = elements[position];
+    if(element.state == INVALID || element.state == UNCONFIRMED ||
+       getIdleCounter(iterator(this, position)) > dsme->getMAC_PIB().macDSMEGTSExpirationTime) {
+        deallocationCandidates.set(position, true);
+    }
+}
+
 uint16_t DSMEAllocationCounterTable::getNumAllocatedGTS(uint16_t address, Direction direction) {
     int d = (direction == TX) ? 0 : 1;
-    RBTree<uint16_t, uint16_t>::iterator numSlotIt = numAllocatedSlots[d].find(address);
-    if(numSlotIt == numAllocatedSlots[d].end()) {
+    neighbor_iterator neighborIt = neighbors.find(address);
+    if(neighborIt == neighbors.end()) {
         return 0;
     } else {
-        return *numSlotIt;
+        return neighborIt->numSlots[d];
     }
 }
 
@@ -229,12 +395,7 @@ void DSMEAllocationCounterTable::setACTState(DSMESABSpecification& subBlock, ACT
 
 void DSMEAllocationCounterTable::setACTState(DSMESABSpecification& subBlock, ACTState state, Direction direction, uint16_t deviceAddress,
                                              uint16_t channelOffset, bool useChannelOffset, condition_t condition, bool checkAddress) {
-    // Supporting more than one slot allocation induces many open issues and is probably not needed most of the time.
-    if(subBlock.getSubBlock().count(true) < 1) {
-        return;
-    }
-    DSME_ASSERT(subBlock.getSubBlock().count(true) == 1);
-
+    /* '-> every set bit is handled on its own, so a multi-slot reply, notify or deallocation updates all of its slots */
     for(DSMESABSpecification::SABSubBlock::iterator it = subBlock.getSubBlock().beginSetBits(); it != subBlock.getSubBlock().endSetBits(); ++it) {
         // this calculation assumes there is always exactly one superframe in the subblock
         GTS gts(subBlock.getSubBlockIndex(), (*it) / numChannels, (*it) % numChannels);
@@ -283,6 +444,7 @@ void DSMEAllocationCounterTable::setACTState(DSMESABSpecification& subBlock, ACT
             LOG_DEBUG("set slot " << (uint16_t)actit->getGTSlotID() << " " << (uint16_t)actit->getSuperframeID() << " " << (uint16_t)actit->getChannel()
                                   << " to " << stateToString(state));
             actit->setState(state);
+            updateDeallocationCandidate(getBitmapPosition(actit->getSuperframeID(), actit->getGTSlotID()));
         }
     }
 }
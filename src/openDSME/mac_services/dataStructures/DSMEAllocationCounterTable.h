@@ -49,48 +49,86 @@
 #include "./DSMEBitVector.h"
 #include "./DSMESABSpecification.h"
 #include "./RBTree.h"
+#include "./MinHeap.h"
 
 namespace dsme {
 
-struct ACTPosition {
-    uint16_t superframeID;
-    uint8_t gtSlotID;
+/*
+ * Marks the end of the ACT and of the per-neighbor lists
+ */
+constexpr uint16_t ACT_INVALID_POSITION = 0xFFFF;
 
-    bool operator>(const ACTPosition& other) const {
-        if(this->superframeID > other.superframeID) {
-            return true;
-        }
-        if(this->superframeID < other.superframeID) {
-            return false;
-        }
-        return this->gtSlotID > other.gtSlotID;
-    }
+/*
+ * Secondary index of the ACT, holds the slots allocated towards a single neighbor per direction (0 == TX, 1 == RX)
+ */
+struct ACTNeighborEntry {
+    uint16_t address;
+    uint16_t numSlots[2];
+    uint16_t first[2];
+};
 
-    bool operator<(const ACTPosition& other) const {
-        if(this->superframeID < other.superframeID) {
-            return true;
-        }
-        if(this->superframeID > other.superframeID) {
-            return false;
-        }
-        return this->gtSlotID < other.gtSlotID;
-    }
+/*
+ * Multi-superframe at which the idle counter of an RX slot exceeds the expiration time
+ */
+struct ACTExpiry {
+    uint32_t epoch;
+    uint16_t position;
 
-    bool operator==(const ACTPosition& other) const {
-        return ((superframeID == other.superframeID) && (gtSlotID == other.gtSlotID));
+    bool operator<(const ACTExpiry& other) const {
+        return this->epoch < other.epoch;
     }
 };
 
 class DSMELayer;
+class DSMEAllocationCounterTable;
+
+/*
+ * Iterates either over all elements of the ACT in order of their bitmap position,
+ * over the elements of a single neighbor and direction or over the deallocation candidates.
+ * Two iterators compare equal if they point to the same slot.
+ */
+class ACTIterator {
+public:
+    enum Mode : uint8_t { ALL, NEIGHBOR_LIST, DEALLOCATION_CANDIDATES };
+
+    ACTIterator(DSMEAllocationCounterTable* instance, uint16_t position, Mode mode = ALL) : instance(instance), position(position), mode(mode) {
+    }
+
+    ACTIterator& operator++();
+    ACTIterator operator++(int);
+
+    ACTElement& operator*() const;
+    ACTElement* operator->() const;
+
+    bool operator==(const ACTIterator& other) const {
+        return this->position == other.position;
+    }
+
+    bool operator!=(const ACTIterator& other) const {
+        return this->position != other.position;
+    }
+
+private:
+    DSMEAllocationCounterTable* instance;
+    uint16_t position;
+    Mode mode;
+};
 
 // own allocated slots
 class DSMEAllocationCounterTable {
+    friend class ACTIterator;
+
 public:
-    typedef RBTree<ACTElement, ACTPosition>::iterator iterator;
+    typedef ACTIterator iterator;
+    typedef RBTreeIterator<ACTNeighborEntry, uint16_t> neighbor_iterator;
     typedef bool (*condition_t)(ACTElement);
 
     DSMEAllocationCounterTable();
+    ~DSMEAllocationCounterTable();
 
+    /*
+     * Allocates the tables for exactly the number of GTS in a multi-superframe, all previous entries are dropped
+     */
     void initialize(uint16_t numSuperFramesPerMultiSuperframe, uint8_t numGTSlotsFirstSuperframe, uint8_t numGTSlotsLatterSuperframes, uint8_t numChannels,
                     DSMELayer* dsme);
 
@@ -98,6 +136,20 @@ public:
 
     iterator end();
 
+    /*
+     * Iterates over all slots allocated towards the given neighbor in the given direction
+     */
+    iterator begin(uint16_t address, Direction direction);
+
+    iterator begin(const ACTNeighborEntry& neighbor, Direction direction);
+
+    /*
+     * Iterates over all neighbors with at least one allocated slot
+     */
+    neighbor_iterator beginNeighbors();
+
+    neighbor_iterator endNeighbors();
+
     void clear();
 
     iterator find(uint16_t superframeID, uint8_t gtSlotID);
@@ -110,32 +162,124 @@ public:
 
     bool isAllocated(uint16_t superframeID, uint8_t gtSlotID) const;
 
+    /*
+     * @return mask of the allocated slots of a superframe, bit i is set if slot i is allocated
+     */
+    uint16_t getAllocatedSlots(uint16_t superframeID) const;
+
     uint16_t getNumAllocatedGTS(uint16_t address, Direction direction);
 
+    /*
+     * Has to be called at the start of each multi-superframe, advances the epoch of the idle counters
+     * and marks the RX slots that exceeded macDSMEGTSExpirationTime as deallocation candidates
+     */
+    void startMultiSuperframe();
+
+    uint16_t getIdleCounter(iterator it) const;
+
+    void incrementIdleCounter(iterator it);
+
+    void resetIdleCounter(iterator it);
+
+    /*
+     * Iterates over all slots that are INVALID, UNCONFIRMED or expired.
+     * The candidates are kept conservatively, so the state of each slot has to be checked again.
+     */
+    iterator beginDeallocationCandidates();
+
+    /*
+     * Removes a slot from the deallocation candidates until its state or idle counter changes again
+     */
+    void dropDeallocationCandidate(iterator it);
+
     void setACTState(DSMESABSpecification& subBlock, ACTState state, Direction direction, uint16_t deviceAddress, uint16_t channelOffset, bool useChannelOffset,
                      bool checkAddress = false);
     void setACTState(DSMESABSpecification& subBlock, ACTState state, Direction direction, uint16_t deviceAddress, uint16_t channelOffset, bool useChannelOffset,
                      condition_t condition, bool checkAddress = false);
     void setACTStateIfExists(DSMESABSpecification& subBlock, ACTState state, uint16_t channelOffset);
 
+    /*
+     * @return number of bytes allocated on the heap for the tables
+     */
+    uint32_t getAllocatedMemory() const;
+
 private:
     DSMEAllocationCounterTable(const DSMEAllocationCounterTable& other) = delete;
     uint16_t getBitmapPosition(uint8_t superframeID, uint8_t slotID) const;
+    uint16_t getNextPosition(uint16_t position) const;
+    void scheduleExpiry(uint16_t position);
+    void updateDeallocationCandidate(uint16_t position);
 
     uint16_t numSuperFramesPerMultiSuperframe;
     uint8_t numGTSlotsFirstSuperframe;
     uint8_t numGTSlotsLatterSuperframes;
     uint8_t numChannels;
 
-    BitVector<MAX_SUPERFRAMES_PER_MULTI_SUPERFRAME * MAX_GTSLOTS> bitmap;
-    RBTree<ACTElement, ACTPosition> act;
+    /* the bitmap marks the valid entries of the element array, both are indexed by getBitmapPosition() */
+    RuntimeBitVector bitmap;
+    ACTElement* elements;
 
     // TODO integrate this nicely into the NeighborQueue
-    RBTree<uint16_t, uint16_t> numAllocatedSlots[2]; // 0 == TX, 1 == RX
+    /* every neighbor in the index has at least one slot, so one node per GTS suffices */
+    RBTree<ACTNeighborEntry, uint16_t, RBRuntimeNodePool<ACTNeighborEntry, uint16_t>> neighbors;
+
+    /* number of started multi-superframes, the reference for the lazy idle counters */
+    uint32_t epoch;
+
+    /* exactly one entry per position with expiryScheduled set, entries of removed slots are dropped lazily */
+    MinHeap<ACTExpiry> expiries;
+    RuntimeBitVector expiryScheduled;
+    RuntimeBitVector deallocationCandidates;
 
     DSMELayer* dsme;
 };
 
+/* INLINE FUNCTION DEFINITIONS ***********************************************/
+
+inline ACTIterator& ACTIterator::operator++() {
+    switch(this->mode) {
+        case NEIGHBOR_LIST:
+            this->position = this->instance->elements[this->position].nextInList;
+            break;
+        case DEALLOCATION_CANDIDATES: {
+            uint16_t next = this->instance->deallocationCandidates.findNext(this->position + 1, true);
+            this->position = (next == this->instance->deallocationCandidates.length()) ? ACT_INVALID_POSITION : next;
+            break;
+        }
+        default:
+            this->position = this->instance->getNextPosition(this->position + 1);
+            break;
+    }
+    return *this;
+}
+
+inline ACTIterator ACTIterator::operator++(int) {
+    ACTIterator old = *this;
+    ++(*this);
+    return old;
+}
+
+inline ACTElement& ACTIterator::operator*() const {
+    return this->instance->elements[this->position];
+}
+
+inline ACTElement* ACTIterator::operator->() const {
+    return &this->instance->elements[this->position];
+}
+
+inline uint16_t DSMEAllocationCounterTable::getNextPosition(uint16_t position) const {
+    uint16_t next = this->bitmap.findNext(position, true);
+    return (next == this->bitmap.length()) ? ACT_INVALID_POSITION : next;
+}
+
+inline DSMEAllocationCounterTable::iterator DSMEAllocationCounterTable::find(uint16_t superframeID, uint8_t gtSlotID) {
+    uint16_t position = getBitmapPosition(superframeID, gtSlotID);
+    if(position >= this->bitmap.length() || !this->bitmap.get(position)) {
+        return end();
+    }
+    return iterator(this, position);
+}
+
 } /* namespace dsme */
 
 #endif /* DSMEALLOCATIONCOUNTERTABLE_H_ */
@@ -50,9 +50,19 @@
 
 namespace dsme {
 
+/* STATIC FUNCTIONS **********************************************************/
+
+static inline bit_vector_word_t lowMask(uint8_t number) {
+    return (number >= 64) ? ~(bit_vector_word_t)0 : (((bit_vector_word_t)1 << number) - 1);
+}
+
+static inline uint8_t bitsInWord(uint32_t position, bit_vector_size_t end) {
+    return (end - position >= 64) ? 64 : (end - position);
+}
+
 /* CONSTRUCTORS & DESTRUCTOR *************************************************/
 
-BitVectorBase::BitVectorBase(uint8_t* byte_array) : bitSize(0), byte_array(byte_array), endSetIterator(this, 0, true), endUnsetIterator(this, 0, false) {
+BitVectorBase::BitVectorBase(bit_vector_word_t* words) : bitSize(0), words(words), endSetIterator(this, 0, true), endUnsetIterator(this, 0, false) {
 }
 
 void BitVectorBase::initialize(bit_vector_size_t bitSize, bool initial_fill) {
@@ -62,18 +72,15 @@ void BitVectorBase::initialize(bit_vector_size_t bitSize, bool initial_fill) {
     this->fill(initial_fill);
 }
 
-BitVectorBase::BitVectorBase(uint8_t* byte_array, const BitVectorBase& other)
-    : bitSize(other.bitSize), byte_array(byte_array), endSetIterator(this, other.bitSize, true), endUnsetIterator(this, other.bitSize, false) {
+BitVectorBase::BitVectorBase(bit_vector_word_t* words, const BitVectorBase& other)
+    : bitSize(other.bitSize), words(words), endSetIterator(this, other.bitSize, true), endUnsetIterator(this, other.bitSize, false) {
     this->copyFrom(other);
 }
 
 /* PUBLIC METHODS ************************************************************/
 
 BitVectorBase::iterator BitVectorBase::beginSetBits() {
-    bit_vector_size_t currentpos = 0;
-    for(currentpos = 0; currentpos < this->bitSize && !this->get(currentpos); currentpos++) {
-    }
-    return iterator(this, currentpos, true);
+    return iterator(this, findNext(0, true), true);
 }
 
 const BitVectorBase::iterator BitVectorBase::endSetBits() const {
@@ -81,10 +88,7 @@ const BitVectorBase::iterator BitVectorBase::endSetBits() const {
 }
 
 BitVectorBase::iterator BitVectorBase::beginUnsetBits() {
-    bit_vector_size_t currentpos = 0;
-    for(currentpos = 0; currentpos < this->bitSize && this->get(currentpos); currentpos++) {
-    }
-    return iterator(this, currentpos, false);
+    return iterator(this, findNext(0, false), false);
 }
 
 const BitVectorBase::iterator BitVectorBase::endUnsetBits() const {
@@ -92,8 +96,10 @@ const BitVectorBase::iterator BitVectorBase::endUnsetBits() const {
 }
 
 void BitVectorBase::fill(bool value) {
-    for(uint16_t i = 0; i < BITVECTOR_BYTE_LENGTH(this->bitSize); i++) {
-        this->byte_array[i] = value * 0xFF;
+    /* '-> whole bytes are filled to keep the serialized padding bits as they were */
+    bit_vector_size_t end = BITVECTOR_BYTE_LENGTH(this->bitSize) * 8;
+    for(uint32_t i = 0; i < end; i += 64) {
+        this->setBits(i, bitsInWord(i, end), value ? ~(bit_vector_word_t)0 : 0);
     }
 }
 
@@ -105,9 +111,9 @@ void BitVectorBase::set(bit_vector_size_t position, bool value) {
     }
 
     if(value) {
-        this->byte_array[position >> 3] |= (1 << (position & 0x07));
+        this->words[position >> 6] |= ((bit_vector_word_t)1 << (position & 0x3F));
     } else {
-        this->byte_array[position >> 3] &= ~(1 << (position & 0x07));
+        this->words[position >> 6] &= ~((bit_vector_word_t)1 << (position & 0x3F));
     }
 }
 
@@ -118,7 +124,7 @@ bool BitVectorBase::get(bit_vector_size_t position) const {
         return false;
     }
 
-    return (this->byte_array[position >> 3] & (1 << (position & 0x07)));
+    return (this->words[position >> 6] >> (position & 0x3F)) & 1;
 }
 
 bit_vector_size_t BitVectorBase::length() const {
@@ -132,21 +138,9 @@ void BitVectorBase::copyFrom(const BitVectorBase& other, bit_vector_size_t their
         return;
     }
 
-    if((theirOffset % 8) == 0) {
-        bit_vector_size_t fullBytes = BITVECTOR_BYTE_LENGTH(this->bitSize + 1) - 1;
-        bit_vector_size_t offsetByte = (theirOffset / 8);
-
-        for(bit_vector_size_t i = 0; i < fullBytes; i++) {
-            this->byte_array[i] = other.byte_array[offsetByte + i];
-        }
-
-        for(bit_vector_size_t i = (fullBytes * 8); i < this->bitSize; i++) {
-            this->set(i, other.get((offsetByte * 8) + i));
-        }
-    } else {
-        for(bit_vector_size_t i = 0; i < this->bitSize; i++) {
-            this->set(i, other.get(theirOffset + i));
-        }
+    for(uint32_t i = 0; i < this->bitSize; i += 64) {
+        uint8_t number = bitsInWord(i, this->bitSize);
+        this->setBits(i, number, other.getBits(theirOffset + i, number));
     }
     return;
 }
@@ -158,21 +152,18 @@ void BitVectorBase::setOperationJoin(const BitVectorBase& other, bit_vector_size
         return;
     }
 
-    if((myOffset % 8) == 0) {
-        bit_vector_size_t fullBytes = BITVECTOR_BYTE_LENGTH(other.bitSize + 1) - 1;
-        bit_vector_size_t offsetByte = (myOffset / 8);
-
-        for(bit_vector_size_t i = 0; i < fullBytes; i++) {
-            this->byte_array[offsetByte + i] |= other.byte_array[i];
+    uint32_t i = 0;
+    if((myOffset & 0x3F) == 0) {
+        /* '-> word aligned, e.g. for whole multi-superframe bitmaps, the compiler vectorizes this loop if possible */
+        bit_vector_word_t* mine = this->words + (myOffset >> 6);
+        for(; i + 64 <= other.bitSize; i += 64) {
+            mine[i >> 6] |= other.words[i >> 6];
         }
+    }
 
-        for(bit_vector_size_t i = (fullBytes * 8); i < other.bitSize; i++) {
-            this->set((offsetByte * 8) + i, this->get((offsetByte * 8) + i) || other.get(i));
-        }
-    } else {
-        for(bit_vector_size_t i = 0; i < other.bitSize; i++) {
-            this->set(myOffset + i, this->get(myOffset + i) || other.get(i));
-        }
+    for(; i < other.bitSize; i += 64) {
+        uint8_t number = bitsInWord(i, other.bitSize);
+        this->setBits(myOffset + i, number, this->getBits(myOffset + i, number) | other.getBits(i, number));
     }
     return;
 }
@@ -184,36 +175,25 @@ void BitVectorBase::setOperationComplement(const BitVectorBase& other, bit_vecto
         return;
     }
 
-    if((myOffset % 8) == 0) {
-        bit_vector_size_t fullBytes = BITVECTOR_BYTE_LENGTH(other.bitSize + 1) - 1;
-        bit_vector_size_t offsetByte = (myOffset / 8);
-
-        for(bit_vector_size_t i = 0; i < fullBytes; i++) {
-            this->byte_array[offsetByte + i] &= ~other.byte_array[i];
+    uint32_t i = 0;
+    if((myOffset & 0x3F) == 0) {
+        /* '-> word aligned, e.g. for whole multi-superframe bitmaps, the compiler vectorizes this loop if possible */
+        bit_vector_word_t* mine = this->words + (myOffset >> 6);
+        for(; i + 64 <= other.bitSize; i += 64) {
+            mine[i >> 6] &= ~other.words[i >> 6];
         }
+    }
 
-        for(bit_vector_size_t i = (fullBytes * 8); i < other.bitSize; i++) {
-            this->set((offsetByte * 8) + i, this->get((offsetByte * 8) + i) && !other.get(i));
-        }
-    } else {
-        for(bit_vector_size_t i = 0; i < other.bitSize; i++) {
-            this->set(myOffset + i, this->get(myOffset + i) && !other.get(i));
-        }
+    for(; i < other.bitSize; i += 64) {
+        uint8_t number = bitsInWord(i, other.bitSize);
+        this->setBits(myOffset + i, number, this->getBits(myOffset + i, number) & ~other.getBits(i, number));
     }
     return;
 }
 
 bool BitVectorBase::isZero() const {
-    bit_vector_size_t fullBytes = BITVECTOR_BYTE_LENGTH(this->bitSize + 1) - 1;
-
-    for(bit_vector_size_t i = 0; i < fullBytes; i++) {
-        if(byte_array[i] != 0) {
-            return false;
-        }
-    }
-
-    for(bit_vector_size_t i = (fullBytes * 8); i < this->bitSize; i++) {
-        if(this->get(i)) {
+    for(bit_vector_size_t i = 0; i < BITVECTOR_WORD_LENGTH(this->bitSize); i++) {
+        if(this->getMaskedWord(i) != 0) {
             return false;
         }
     }
@@ -223,24 +203,32 @@ bool BitVectorBase::isZero() const {
 
 bit_vector_size_t BitVectorBase::count(bool value) const {
     bit_vector_size_t count = 0;
-    bit_vector_size_t fullBytes = BITVECTOR_BYTE_LENGTH(this->bitSize + 1) - 1;
 
-    for(bit_vector_size_t i = 0; i < fullBytes; i++) {
-        uint8_t x = this->byte_array[i];
-        if(!value) {
-            x = ~x;
-        }
-        while(x > 0) {
-            count++;
-            x &= x - 1; // Wegner (1960)
-        }
+    for(bit_vector_size_t i = 0; i < BITVECTOR_WORD_LENGTH(this->bitSize); i++) {
+        count += __builtin_popcountll(this->getMaskedWord(i));
     }
 
-    for(bit_vector_size_t i = (fullBytes * 8); i < this->bitSize; i++) {
-        count += this->get(i) ^ (!value);
+    return value ? count : (this->bitSize - count);
+}
+
+bit_vector_size_t BitVectorBase::findNext(bit_vector_size_t start, bool value) const {
+    if(start >= this->bitSize) {
+        return this->bitSize;
+    }
+
+    bit_vector_size_t word = start >> 6;
+    bit_vector_size_t lastWord = (this->bitSize - 1) >> 6;
+    bit_vector_word_t bits = this->getMaskedWord(word, value) & (~(bit_vector_word_t)0 << (start & 0x3F));
+
+    while(bits == 0) {
+        if(word == lastWord) {
+            return this->bitSize;
+        }
+        word++;
+        bits = this->getMaskedWord(word, value);
     }
 
-    return count;
+    return (word << 6) + __builtin_ctzll(bits);
 }
 
 bool BitVectorBase::operator==(const BitVectorBase& other) const {
@@ -248,16 +236,8 @@ bool BitVectorBase::operator==(const BitVectorBase& other) const {
         return false;
     }
 
-    bit_vector_size_t fullBytes = BITVECTOR_BYTE_LENGTH(this->bitSize + 1) - 1;
-
-    for(bit_vector_size_t i = 0; i < fullBytes; i++) {
-        if(this->byte_array[i] != other.byte_array[i]) {
-            return false;
-        }
-    }
-
-    for(bit_vector_size_t i = (fullBytes * 8); i < this->bitSize; i++) {
-        if(this->get(i) != other.get(i)) {
+    for(bit_vector_size_t i = 0; i < BITVECTOR_WORD_LENGTH(this->bitSize); i++) {
+        if(this->getMaskedWord(i) != other.getMaskedWord(i)) {
             return false;
         }
     }
@@ -273,9 +253,66 @@ uint8_t BitVectorBase::getSerializationLength() const {
     return BITVECTOR_BYTE_LENGTH(bitSize);
 }
 
+bit_vector_word_t BitVectorBase::getBits(bit_vector_size_t position, uint8_t number) const {
+    bit_vector_size_t word = position >> 6;
+    uint8_t shift = position & 0x3F;
+
+    bit_vector_word_t bits = this->words[word] >> shift;
+    if(shift != 0 && shift + number > 64) {
+        /* '-> funnel shift with the following word */
+        bits |= this->words[word + 1] << (64 - shift);
+    }
+    return bits & lowMask(number);
+}
+
+void BitVectorBase::setBits(bit_vector_size_t position, uint8_t number, bit_vector_word_t bits) {
+    bit_vector_size_t word = position >> 6;
+    uint8_t shift = position & 0x3F;
+
+    bits &= lowMask(number);
+    bit_vector_word_t mask = lowMask(number) << shift;
+    this->words[word] = (this->words[word] & ~mask) | (bits << shift);
+
+    if(shift != 0 && shift + number > 64) {
+        mask = lowMask(shift + number - 64);
+        this->words[word + 1] = (this->words[word + 1] & ~mask) | (bits >> (64 - shift));
+    }
+}
+
+void RuntimeBitVector::setLength(bit_vector_size_t bitSize, bool initial_fill) {
+    uint16_t requiredWords = BITVECTOR_WORD_LENGTH(bitSize);
+    if(requiredWords != this->numWords) {
+        delete[] this->words;
+        this->words = new bit_vector_word_t[requiredWords];
+        this->numWords = requiredWords;
+    }
+    initialize(bitSize, initial_fill);
+}
+
+/* PRIVATE METHODS ***********************************************************/
+
+/*
+ * @return the given word with all bits inverted if value is false and all bits beyond the length cleared
+ */
+bit_vector_word_t BitVectorBase::getMaskedWord(bit_vector_size_t word, bool value) const {
+    bit_vector_word_t bits = value ? this->words[word] : ~this->words[word];
+    uint32_t start = (uint32_t)word << 6;
+    if(start + 64 > this->bitSize) {
+        bits &= lowMask(this->bitSize - start);
+    }
+    return bits;
+}
+
 Serializer& operator<<(Serializer& serializer, const BitVectorBase& bv) {
     for(bit_vector_size_t i = 0; i < BITVECTOR_BYTE_LENGTH(bv.bitSize); i++) {
-        serializer << bv.byte_array[i];
+        bit_vector_word_t& word = bv.words[i >> 3];
+        uint8_t shift = (i & 0x07) * 8;
+
+        uint8_t byte = (word >> shift) & 0xFF;
+        serializer << byte;
+        if(serializer.getType() == DESERIALIZATION) {
+            word = (word & ~((bit_vector_word_t)0xFF << shift)) | ((bit_vector_word_t)byte << shift);
+        }
     }
 
     return serializer;
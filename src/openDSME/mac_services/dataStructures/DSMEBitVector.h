@@ -54,18 +54,26 @@ class Serializer;
 /* DEFINES & MACROS **********************************************************/
 
 #define BITVECTOR_BYTE_LENGTH(len) (((len - 1) / 8) + 1)
+#define BITVECTOR_WORD_LENGTH(len) (((len - 1) / 64) + 1)
 
 /* CLASSES *******************************************************************/
 
 namespace dsme {
 
+/*
+ * The bits are stored in 64 bit words, bit i is located in word i / 64 at position i % 64.
+ * For the serialization the words are split into bytes in little endian order,
+ * so the byte layout is the same as if bit i was stored in byte i / 8 at position i % 8.
+ */
+typedef uint64_t bit_vector_word_t;
+
 class BitVectorBase {
     friend class BitVectorIterator;
 
 public:
     typedef BitVectorIterator iterator;
 
-    explicit BitVectorBase(uint8_t* byte_array);
+    explicit BitVectorBase(bit_vector_word_t* words);
 
     void initialize(bit_vector_size_t bitSize, bool initial_fill = false);
 
@@ -86,6 +94,21 @@ public:
 
     bit_vector_size_t count(bool value) const;
 
+    /*
+     * @return the first position >= start with the given value or length() if there is none
+     */
+    bit_vector_size_t findNext(bit_vector_size_t start, bool value) const;
+
+    /*
+     * Reads up to 64 bits starting at an arbitrary position, the bit at position becomes the least significant bit
+     */
+    bit_vector_word_t getBits(bit_vector_size_t position, uint8_t number) const;
+
+    /*
+     * Writes up to 64 bits starting at an arbitrary position, the remaining bits are kept
+     */
+    void setBits(bit_vector_size_t position, uint8_t number, bit_vector_word_t bits);
+
     void copyFrom(const BitVectorBase& other, bit_vector_size_t theirOffset = 0);
 
     void setOperationJoin(const BitVectorBase& other, bit_vector_size_t myOffset = 0);
@@ -101,12 +124,15 @@ public:
 
 protected:
     bit_vector_size_t bitSize;
-    uint8_t* const byte_array;
+    bit_vector_word_t* words;
 
     iterator endSetIterator;
     iterator endUnsetIterator;
 
-    BitVectorBase(uint8_t* byte_array, const BitVectorBase& other);
+    BitVectorBase(bit_vector_word_t* words, const BitVectorBase& other);
+
+private:
+    bit_vector_word_t getMaskedWord(bit_vector_size_t word, bool value = true) const;
 
     friend Serializer& operator<<(Serializer& serializer, const BitVectorBase& bv);
 };
@@ -143,7 +169,36 @@ public:
     }
 
 private:
-    uint8_t array[BITVECTOR_BYTE_LENGTH(MAX_SIZE)];
+    bit_vector_word_t array[BITVECTOR_WORD_LENGTH(MAX_SIZE)];
+};
+
+/*
+ * BitVector for tables whose length is only known at runtime.
+ * The words are allocated on the heap and sized exactly for the length given to setLength.
+ */
+class RuntimeBitVector : public BitVectorBase {
+public:
+    RuntimeBitVector() : BitVectorBase(nullptr), numWords(0) {
+    }
+
+    ~RuntimeBitVector() {
+        delete[] this->words;
+    }
+
+    RuntimeBitVector(const RuntimeBitVector&) = delete;
+    RuntimeBitVector& operator=(const RuntimeBitVector&) = delete;
+
+    /*
+     * Reallocates the words if the length requires a different number of them, all bits are set to initial_fill
+     */
+    void setLength(bit_vector_size_t bitSize, bool initial_fill = false);
+
+    uint32_t getAllocatedMemory() const {
+        return numWords * sizeof(bit_vector_word_t);
+    }
+
+private:
+    uint16_t numWords;
 };
 
 } /* namespace dsme */
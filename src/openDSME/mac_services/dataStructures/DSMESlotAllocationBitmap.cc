@@ -42,6 +42,7 @@
 
 #include "./DSMESlotAllocationBitmap.h"
 
+#include "../../../dsme_platform.h"
 #include "./DSMEBitVector.h"
 #include "./DSMESABSpecification.h"
 #include "./GTS.h"
@@ -49,52 +50,107 @@
 namespace dsme {
 
 DSMESlotAllocationBitmap::DSMESlotAllocationBitmap()
-    : numSuperframesPerMultiSuperframe(0), numGTSlotsFirstSuperframe(0), numGTSlotsLatterSuperframes(0), numChannels(0) {
+    : occupied(nullptr), freeSlots(nullptr), numFreeSlots(0), numSuperframesPerMultiSuperframe(0), numGTSlotsFirstSuperframe(0), numGTSlotsLatterSuperframes(0),
+      numChannels(0) {
+}
+
+DSMESlotAllocationBitmap::~DSMESlotAllocationBitmap() {
+    delete[] occupied;
+    delete[] freeSlots;
 }
 
 void DSMESlotAllocationBitmap::initialize(uint16_t numSuperframesPerMultiSuperframe, uint8_t numGTSlotsFirstSuperframe, uint8_t numGTSlotsLatterSuperframes,
                                           uint8_t numChannels) {
+    DSME_ASSERT(numSuperframesPerMultiSuperframe <= MAX_SUPERFRAMES_PER_MULTI_SUPERFRAME);
+    DSME_ASSERT(numChannels <= MAX_CHANNELS);
+
+    delete[] occupied;
+    delete[] freeSlots;
+
     this->numSuperframesPerMultiSuperframe = numSuperframesPerMultiSuperframe;
     this->numGTSlotsFirstSuperframe = numGTSlotsFirstSuperframe;
     this->numGTSlotsLatterSuperframes = numGTSlotsLatterSuperframes;
     this->numChannels = numChannels;
-    occupied.initialize((numGTSlotsFirstSuperframe + (numSuperframesPerMultiSuperframe - 1) * numGTSlotsLatterSuperframes) * numChannels);
+
+    occupied = new uint16_t[getSubblockOffset(numSuperframesPerMultiSuperframe)];
+    freeSlots = new uint16_t[numSuperframesPerMultiSuperframe];
+    clear();
     return;
 }
 
 void DSMESlotAllocationBitmap::clear() {
-    occupied.fill(false);
+    for(uint16_t i = 0; i < getSubblockOffset(numSuperframesPerMultiSuperframe); i++) {
+        occupied[i] = 0;
+    }
+
+    numFreeSlots = 0;
+    for(uint16_t i = 0; i < numSuperframesPerMultiSuperframe; i++) {
+        freeSlots[i] = (1 << getNumGTSlots(i)) - 1;
+        numFreeSlots += getNumGTSlots(i);
+    }
 }
 
-uint16_t DSMESlotAllocationBitmap::getSubblockOffset(uint8_t subBlockIndex) const {
-    if(subBlockIndex == 0) {
-        return 0;
-    } else {
-        return (numGTSlotsFirstSuperframe + (subBlockIndex - 1) * numGTSlotsLatterSuperframes) * numChannels;
+void DSMESlotAllocationBitmap::updateFreeSlot(uint8_t subBlockIndex, uint8_t slotID) {
+    uint16_t allChannels = (1 << numChannels) - 1;
+    bool free = (occupied[getSubblockOffset(subBlockIndex) + slotID] != allChannels);
+    bool wasFree = (freeSlots[subBlockIndex] >> slotID) & 1;
+
+    if(free && !wasFree) {
+        freeSlots[subBlockIndex] |= (1 << slotID);
+        numFreeSlots++;
+    } else if(!free && wasFree) {
+        freeSlots[subBlockIndex] &= ~(1 << slotID);
+        numFreeSlots--;
     }
 }
 
 void DSMESlotAllocationBitmap::addOccupiedSlots(const DSMESABSpecification& subBlock) {
-    occupied.setOperationJoin(subBlock.getSubBlock(), getSubblockOffset(subBlock.getSubBlockIndex()));
+    if(subBlock.getSubBlockIndex() >= numSuperframesPerMultiSuperframe) {
+        /* '-> the sub block does not belong to the configured multi-superframe */
+        return;
+    }
+
+    const DSMESABSpecification::SABSubBlock& bits = subBlock.getSubBlock();
+    uint16_t* slots = occupied + getSubblockOffset(subBlock.getSubBlockIndex());
+    uint8_t numGTSlots = getNumGTSlots(subBlock.getSubBlockIndex());
+
+    for(uint8_t i = 0; i < numGTSlots && (i + 1) * numChannels <= bits.length(); i++) {
+        slots[i] |= bits.getBits(i * numChannels, numChannels);
+        updateFreeSlot(subBlock.getSubBlockIndex(), i);
+    }
     return;
 }
 
 void DSMESlotAllocationBitmap::removeOccupiedSlots(const DSMESABSpecification& subBlock) {
-    occupied.setOperationComplement(subBlock.getSubBlock(), getSubblockOffset(subBlock.getSubBlockIndex()));
+    if(subBlock.getSubBlockIndex() >= numSuperframesPerMultiSuperframe) {
+        /* '-> the sub block does not belong to the configured multi-superframe */
+        return;
+    }
+
+    const DSMESABSpecification::SABSubBlock& bits = subBlock.getSubBlock();
+    uint16_t* slots = occupied + getSubblockOffset(subBlock.getSubBlockIndex());
+    uint8_t numGTSlots = getNumGTSlots(subBlock.getSubBlockIndex());
+
+    for(uint8_t i = 0; i < numGTSlots && (i + 1) * numChannels <= bits.length(); i++) {
+        slots[i] &= ~bits.getBits(i * numChannels, numChannels);
+        updateFreeSlot(subBlock.getSubBlockIndex(), i);
+    }
     return;
 }
 
 void DSMESlotAllocationBitmap::getOccupiedSubBlock(DSMESABSpecification& subBlock, uint16_t subBlockIndex) const {
-    subBlock.getSubBlock().copyFrom(occupied, getSubblockOffset(subBlockIndex));
-    return;
-}
+    DSMESABSpecification::SABSubBlock& bits = subBlock.getSubBlock();
+    const uint16_t* slots = occupied + getSubblockOffset(subBlockIndex);
+    uint8_t numGTSlots = getNumGTSlots(subBlockIndex);
 
-void DSMESlotAllocationBitmap::getOccupiedChannels(BitVector<MAX_CHANNELS>& channelVector, uint16_t subBlockIndex, uint16_t subBlockOffset) const {
-    channelVector.copyFrom(occupied, getSubblockOffset(subBlockIndex) + subBlockOffset * numChannels);
+    for(uint8_t i = 0; i < numGTSlots && (i + 1) * numChannels <= bits.length(); i++) {
+        bits.setBits(i * numChannels, numChannels, slots[i]);
+    }
+    return;
 }
 
 bool DSMESlotAllocationBitmap::isOccupied(abs_slot_idx_t idx) {
-    return occupied.get(idx);
+    return (occupied[idx / numChannels] >> (idx % numChannels)) & 1;
 }
 
 } /* namespace dsme */
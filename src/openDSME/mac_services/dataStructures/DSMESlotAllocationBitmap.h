@@ -52,7 +52,14 @@ namespace dsme {
 class DSMESlotAllocationBitmap {
 public:
     DSMESlotAllocationBitmap();
+    ~DSMESlotAllocationBitmap();
 
+    DSMESlotAllocationBitmap(const DSMESlotAllocationBitmap&) = delete;
+    DSMESlotAllocationBitmap& operator=(const DSMESlotAllocationBitmap&) = delete;
+
+    /**
+     * Allocates the tables for exactly the configured multi-superframe, all entries are cleared
+     */
     void initialize(uint16_t numSuperframesPerMultiSuperframe, uint8_t numGTSlotsFirstSuperframe, uint8_t numGTSlotsLatterSuperframes, uint8_t numChannels);
 
     /**
@@ -66,9 +73,11 @@ public:
     void getOccupiedSubBlock(DSMESABSpecification& subBlock, uint16_t subBlockIndex) const;
 
     /**
-     * Get bit vector of occupied channels
+     * Get mask of occupied channels, bit i is set if channel i is occupied
      */
-    void getOccupiedChannels(BitVector<MAX_CHANNELS>& channelVector, uint16_t subBlockIndex, uint16_t subBlockOffset) const;
+    uint16_t getOccupiedChannels(uint16_t subBlockIndex, uint16_t subBlockOffset) const {
+        return occupied[getSubblockOffset(subBlockIndex) + subBlockOffset];
+    }
 
     /**
      * Update slot occupation of neighborhood on receipt of reply/notify
@@ -82,10 +91,51 @@ public:
 
     bool isOccupied(abs_slot_idx_t idx);
 
+    /**
+     * Get mask of the slots of a superframe with at least one free channel, bit i is set if slot i is free
+     */
+    uint16_t getFreeSlots(uint16_t subBlockIndex) const {
+        return freeSlots[subBlockIndex];
+    }
+
+    uint8_t getNumFreeSlots(uint16_t subBlockIndex) const {
+        return __builtin_popcount(freeSlots[subBlockIndex]);
+    }
+
+    bool hasFreeSlots() const {
+        return numFreeSlots > 0;
+    }
+
+    /**
+     * Get number of bytes allocated on the heap for the tables
+     */
+    uint32_t getAllocatedMemory() const {
+        return (getSubblockOffset(numSuperframesPerMultiSuperframe) + numSuperframesPerMultiSuperframe) * sizeof(uint16_t);
+    }
+
 private:
-    uint16_t getSubblockOffset(uint8_t subBlockIndex) const;
+    uint16_t getSubblockOffset(uint16_t subBlockIndex) const {
+        if(subBlockIndex == 0) {
+            return 0;
+        } else {
+            return numGTSlotsFirstSuperframe + (subBlockIndex - 1) * numGTSlotsLatterSuperframes;
+        }
+    }
+
+    uint8_t getNumGTSlots(uint8_t subBlockIndex) const {
+        return (subBlockIndex == 0) ? numGTSlotsFirstSuperframe : numGTSlotsLatterSuperframes;
+    }
+
+    void updateFreeSlot(uint8_t subBlockIndex, uint8_t slotID);
+
+    static_assert(MAX_CHANNELS <= 16, "The channel mask of a slot has to fit into 16 bit");
+    static_assert(MAX_GTSLOTS <= 16, "The free slot mask of a superframe has to fit into 16 bit");
+
+    uint16_t* occupied; // channels occupied by neighbors per (superframe, slot)
 
-    BitVector<MAX_OCCUPIED_SLOTS> occupied; // occupied by neighbors
+    /* index of the slots with at least one free channel, kept up to date by addOccupiedSlots and removeOccupiedSlots */
+    uint16_t* freeSlots;
+    uint16_t numFreeSlots;
     uint16_t numSuperframesPerMultiSuperframe;
     uint8_t numGTSlotsFirstSuperframe;
     uint8_t numGTSlotsLatterSuperframes;
@@ -0,0 +1,181 @@
+/*
+ * openDSME
+ *
+ * Implementation of the Deterministic & Synchronous Multi-channel Extension (DSME)
+ * introduced in the IEEE 802.15.4e-2012 standard
+ *
+ * Authors: Florian Meier <florian.meier@tuhh.de>
+ *          Maximilian Koestler <maximilian.koestler@tuhh.de>
+ *          Sandrina Backhauss <sandrina.backhauss@tuhh.de>
+ *
+ * Based on
+ *          DSME Implementation for the INET Framework
+ *          Tobias Luebkert <tobias.luebkert@tuhh.de>
+ *
+ * Copyright (c) 2015, Institute of Telematics, Hamburg University of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef MINHEAP_H_
+#define MINHEAP_H_
+
+#include "../../helper/Integers.h"
+
+namespace dsme {
+
+/* CLASSES *******************************************************************/
+
+/*
+ * Binary min-heap, the smallest element according to operator< is on top.
+ * The storage is allocated by setCapacity() and not resized while elements are pushed.
+ */
+template <typename T>
+class MinHeap {
+public:
+    MinHeap() : heap(nullptr), capacity(0), count(0), highWaterMark(0) {
+    }
+
+    ~MinHeap() {
+        delete[] heap;
+    }
+
+    MinHeap(const MinHeap&) = delete;
+    MinHeap& operator=(const MinHeap&) = delete;
+
+    /*
+     * Allocates the storage for exactly capacity elements, the heap is cleared
+     */
+    void setCapacity(uint16_t capacity);
+
+    uint32_t getAllocatedMemory() const {
+        return capacity * sizeof(T);
+    }
+
+    /*
+     * @return false if the heap is full
+     */
+    bool push(const T& value);
+
+    /*
+     * Removes the top element, the heap must not be empty
+     */
+    void pop();
+
+    const T& top() const {
+        return heap[0];
+    }
+
+    uint16_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+    /*
+     * Maximum of size() since the last resetHighWaterMark()
+     */
+    uint16_t getHighWaterMark() const {
+        return highWaterMark;
+    }
+
+    void resetHighWaterMark() {
+        highWaterMark = count;
+    }
+
+private:
+    T* heap;
+    uint16_t capacity;
+    uint16_t count;
+    uint16_t highWaterMark;
+};
+
+/* FUNCTION DEFINITIONS ******************************************************/
+
+template <typename T>
+void MinHeap<T>::setCapacity(uint16_t capacity) {
+    if(capacity != this->capacity) {
+        delete[] heap;
+        heap = (capacity > 0) ? new T[capacity] : nullptr;
+        this->capacity = capacity;
+    }
+    count = 0;
+    highWaterMark = 0;
+}
+
+template <typename T>
+bool MinHeap<T>::push(const T& value) {
+    if(count == capacity) {
+        return false;
+    }
+
+    uint16_t i = count++;
+    while(i > 0) {
+        uint16_t parent = (i - 1) / 2;
+        if(!(value < heap[parent])) {
+            break;
+        }
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = value;
+    if(count > highWaterMark) {
+        highWaterMark = count;
+    }
+    return true;
+}
+
+template <typename T>
+void MinHeap<T>::pop() {
+    T last = heap[--count];
+
+    uint16_t i = 0;
+    while(true) {
+        uint16_t child = 2 * i + 1;
+        if(child >= count) {
+            break;
+        }
+        if(child + 1 < count && heap[child + 1] < heap[child]) {
+            child++;
+        }
+        if(!(heap[child] < last)) {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+}
+
+} /* namespace dsme */
+
+#endif /* MINHEAP_H_ */
@@ -52,7 +52,7 @@ namespace dsme {
 enum color_t { RED, BLACK };
 
 /* CLASSES *******************************************************************/
-template <typename T, typename K>
+template <typename T, typename K, typename A>
 class RBTree;
 
 template <typename T, typename K>
@@ -0,0 +1,221 @@
+/*
+ * openDSME
+ *
+ * Implementation of the Deterministic & Synchronous Multi-channel Extension (DSME)
+ * introduced in the IEEE 802.15.4e-2012 standard
+ *
+ * Authors: Florian Meier <florian.meier@tuhh.de>
+ *          Maximilian Koestler <maximilian.koestler@tuhh.de>
+ *          Sandrina Backhauss <sandrina.backhauss@tuhh.de>
+ *
+ * Based on
+ *          DSME Implementation for the INET Framework
+ *          Tobias Luebkert <tobias.luebkert@tuhh.de>
+ *
+ * Copyright (c) 2015, Institute of Telematics, Hamburg University of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef RBNODEPOOL_H_
+#define RBNODEPOOL_H_
+
+#include <new>
+
+#include "../../helper/Integers.h"
+#include "./RBNode.h"
+
+namespace dsme {
+
+/* CLASSES *******************************************************************/
+
+/*
+ * Fixed-capacity arena for the nodes of an RBTree.
+ * All nodes are preallocated together with the tree, unused ones are kept in a free list.
+ * Every allocator of an RBTree has to provide allocate() and release() with these semantics.
+ *
+ * @template-param CAPACITY maximum number of nodes in the tree
+ */
+template <typename T, typename K, uint16_t CAPACITY>
+class RBNodePool {
+public:
+    RBNodePool();
+
+    RBNodePool(const RBNodePool&) = delete;
+    RBNodePool& operator=(const RBNodePool&) = delete;
+
+    /*
+     * Takes a node from the free list and constructs it
+     * @return the new node or nullptr if the pool is exhausted
+     */
+    RBNode<T, K>* allocate(const T& content, const K& key);
+
+    /*
+     * Destructs the node and returns it to the free list
+     */
+    void release(RBNode<T, K>* node);
+
+    uint16_t capacity() const {
+        return CAPACITY;
+    }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(RBNode<T, K>) uint8_t storage[sizeof(RBNode<T, K>)];
+    };
+
+    Slot slots[CAPACITY];
+    Slot* freeList;
+};
+
+/*
+ * Arena for the nodes of an RBTree whose capacity is only known at runtime.
+ * The nodes are allocated at once in initialize(), afterwards it behaves like RBNodePool.
+ */
+template <typename T, typename K>
+class RBRuntimeNodePool {
+public:
+    RBRuntimeNodePool();
+    ~RBRuntimeNodePool();
+
+    RBRuntimeNodePool(const RBRuntimeNodePool&) = delete;
+    RBRuntimeNodePool& operator=(const RBRuntimeNodePool&) = delete;
+
+    /*
+     * Allocates the storage for all nodes, has to be called before the first allocate().
+     * Calling it again discards the previous storage, so all nodes have to be released before.
+     * @param capacity maximum number of nodes in the tree
+     */
+    void initialize(uint16_t capacity);
+
+    /*
+     * Takes a node from the free list and constructs it
+     * @return the new node or nullptr if the pool is exhausted or not yet initialized
+     */
+    RBNode<T, K>* allocate(const T& content, const K& key);
+
+    /*
+     * Destructs the node and returns it to the free list
+     */
+    void release(RBNode<T, K>* node);
+
+    uint16_t capacity() const {
+        return numSlots;
+    }
+
+    uint32_t getAllocatedMemory() const {
+        return numSlots * sizeof(Slot);
+    }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(RBNode<T, K>) uint8_t storage[sizeof(RBNode<T, K>)];
+    };
+
+    Slot* slots;
+    uint16_t numSlots;
+    Slot* freeList;
+};
+
+/* FUNCTION DEFINITIONS ******************************************************/
+
+template <typename T, typename K, uint16_t CAPACITY>
+RBNodePool<T, K, CAPACITY>::RBNodePool() : freeList(nullptr) {
+    for(uint16_t i = CAPACITY; i > 0; i--) {
+        slots[i - 1].next = freeList;
+        freeList = &slots[i - 1];
+    }
+}
+
+template <typename T, typename K, uint16_t CAPACITY>
+RBNode<T, K>* RBNodePool<T, K, CAPACITY>::allocate(const T& content, const K& key) {
+    if(freeList == nullptr) {
+        /* '-> all nodes are in use */
+        return nullptr;
+    }
+
+    Slot* slot = freeList;
+    freeList = slot->next;
+    return new(slot->storage) RBNode<T, K>(content, key);
+}
+
+template <typename T, typename K, uint16_t CAPACITY>
+void RBNodePool<T, K, CAPACITY>::release(RBNode<T, K>* node) {
+    node->~RBNode<T, K>();
+
+    Slot* slot = reinterpret_cast<Slot*>(node);
+    slot->next = freeList;
+    freeList = slot;
+}
+
+template <typename T, typename K>
+RBRuntimeNodePool<T, K>::RBRuntimeNodePool() : slots(nullptr), numSlots(0), freeList(nullptr) {
+}
+
+template <typename T, typename K>
+RBRuntimeNodePool<T, K>::~RBRuntimeNodePool() {
+    delete[] slots;
+}
+
+template <typename T, typename K>
+void RBRuntimeNodePool<T, K>::initialize(uint16_t capacity) {
+    delete[] slots;
+
+    slots = new Slot[capacity];
+    numSlots = capacity;
+    freeList = nullptr;
+    for(uint16_t i = capacity; i > 0; i--) {
+        slots[i - 1].next = freeList;
+        freeList = &slots[i - 1];
+    }
+}
+
+template <typename T, typename K>
+RBNode<T, K>* RBRuntimeNodePool<T, K>::allocate(const T& content, const K& key) {
+    if(freeList == nullptr) {
+        /* '-> all nodes are in use */
+        return nullptr;
+    }
+
+    Slot* slot = freeList;
+    freeList = slot->next;
+    return new(slot->storage) RBNode<T, K>(content, key);
+}
+
+template <typename T, typename K>
+void RBRuntimeNodePool<T, K>::release(RBNode<T, K>* node) {
+    node->~RBNode<T, K>();
+
+    Slot* slot = reinterpret_cast<Slot*>(node);
+    slot->next = freeList;
+    freeList = slot;
+}
+
+} /* namespace dsme */
+
+#endif /* RBNODEPOOL_H_ */
@@ -45,6 +45,7 @@
 
 #include "../../helper/Integers.h"
 #include "./RBNode.h"
+#include "./RBNodePool.h"
 #include "./RBTreeIterator.h"
 
 namespace dsme {
@@ -57,12 +58,14 @@ struct RBNode;
 /*
  * generic implementation of an RB-Tree
  * advantage: balanced binary search tree -> find() in maximal O(log n) steps
+ * The nodes are taken from the allocator A, e.g. a fixed-capacity RBNodePool stored within the tree
+ * or an RBRuntimeNodePool sized at initialization.
  */
-template <typename T, typename K>
+template <typename T, typename K, typename A>
 class RBTree {
 public:
     typedef RBTreeIterator<T, K> iterator;
-    typedef uint8_t tree_size_t;
+    typedef uint16_t tree_size_t;
 
     /*
      * initializes tree members
@@ -118,6 +121,17 @@ public:
 
     RBNode<T, K>* getRoot();
 
+    /*
+     * Return the allocator, e.g. to size a runtime node pool before the first insert
+     */
+    A& getAllocator() {
+        return allocator;
+    }
+
+    const A& getAllocator() const {
+        return allocator;
+    }
+
 private:
     /*
      * root node
@@ -129,6 +143,11 @@ private:
      */
     tree_size_t m_size;
 
+    /*
+     * provides the memory for the nodes
+     */
+    A allocator;
+
     /*
      * rotate tree to the right, if not balanced
      * @Param node x is center of the rotation
@@ -174,47 +193,51 @@ private:
 
 /* FUNCTION DEFINITIONS ******************************************************/
 
-template <typename T, typename K>
-RBTree<T, K>::RBTree() : root(nullptr), m_size(0) {
+template <typename T, typename K, typename A>
+RBTree<T, K, A>::RBTree() : root(nullptr), m_size(0) {
 }
 
-template <typename T, typename K>
-RBTree<T, K>::~RBTree() {
+template <typename T, typename K, typename A>
+RBTree<T, K, A>::~RBTree() {
     iterator iter = this->begin();
     while(iter != this->end()) {
-        delete(iter++).currentNode;
+        allocator.release((iter++).currentNode);
     }
 }
 
-template <typename T, typename K>
-RBNode<T, K>* RBTree<T, K>::getRoot() {
+template <typename T, typename K, typename A>
+RBNode<T, K>* RBTree<T, K, A>::getRoot() {
     return root;
 }
 
-template <typename T, typename K>
-typename RBTree<T, K>::iterator RBTree<T, K>::begin() {
-    return RBTree<T, K>::iterator::begin(this, root);
+template <typename T, typename K, typename A>
+typename RBTree<T, K, A>::iterator RBTree<T, K, A>::begin() {
+    return RBTree<T, K, A>::iterator::begin(this, root);
 }
 
-template <typename T, typename K>
-typename RBTree<T, K>::iterator RBTree<T, K>::end() {
-    return RBTree<T, K>::iterator(this, nullptr);
+template <typename T, typename K, typename A>
+typename RBTree<T, K, A>::iterator RBTree<T, K, A>::end() {
+    return RBTree<T, K, A>::iterator(this, nullptr);
 }
 
-template <typename T, typename K>
-const typename RBTree<T, K>::iterator RBTree<T, K>::end() const {
-    return RBTree<T, K>::iterator(this, nullptr);
+template <typename T, typename K, typename A>
+const typename RBTree<T, K, A>::iterator RBTree<T, K, A>::end() const {
+    return RBTree<T, K, A>::iterator(this, nullptr);
 }
 
-template <typename T, typename K>
-bool RBTree<T, K>::insert(T obj, K key) {
+template <typename T, typename K, typename A>
+bool RBTree<T, K, A>::insert(T obj, K key) {
     RBNode<T, K>* node;
     if(m_size == (tree_size_t)-1) {
         /* '-> tree is already full, depends on bit-width of 'tree_size_t' */
         return false;
     }
     if(m_size == 0) {
-        node = new RBNode<T, K>(obj, key);
+        node = allocator.allocate(obj, key);
+        if(node == nullptr) {
+            /* '-> allocator is exhausted */
+            return false;
+        }
         /* '-> tree was empty -> inserted object becomes root */
         node->parent = nullptr;
         node->color = BLACK; // Transformation_1: tree was empty before
@@ -230,7 +253,11 @@ bool RBTree<T, K>::insert(T obj, K key) {
                 /* '-> key is smaller -> left path */
                 if(current->leftChild == nullptr) {
                     /* '-> has no left-side child -> current node sets his child -> position found */
-                    node = new RBNode<T, K>(obj, key);
+                    node = allocator.allocate(obj, key);
+                    if(node == nullptr) {
+                        /* '-> allocator is exhausted */
+                        return false;
+                    }
                     node->parent = current;
                     current->leftChild = node;
                     break;
@@ -240,7 +267,11 @@ bool RBTree<T, K>::insert(T obj, K key) {
                 /* '-> key is larger -> right path */
                 if(current->rightChild == nullptr) {
                     /* '-> has no right-side child -> current node sets his child -> position found */
-                    node = new RBNode<T, K>(obj, key);
+                    node = allocator.allocate(obj, key);
+                    if(node == nullptr) {
+                        /* '-> allocator is exhausted */
+                        return false;
+                    }
                     node->parent = current;
                     current->rightChild = node;
                     break;
@@ -315,8 +346,8 @@ bool RBTree<T, K>::insert(T obj, K key) {
     return true;
 }
 
-template <typename T, typename K>
-void RBTree<T, K>::balanceTree(RBNode<T, K>* node) {
+template <typename T, typename K, typename A>
+void RBTree<T, K, A>::balanceTree(RBNode<T, K>* node) {
     /*
      * node : in first iteration -> deleted node (is black and has no children)
      *        other -> problem node
@@ -421,8 +452,8 @@ void RBTree<T, K>::balanceTree(RBNode<T, K>* node) {
     }
 }
 
-template <typename T, typename K>
-void RBTree<T, K>::remove(iterator& iter) {
+template <typename T, typename K, typename A>
+void RBTree<T, K, A>::remove(iterator& iter) {
     if(iter == end()) {
         return;
     }
@@ -460,7 +491,7 @@ void RBTree<T, K>::remove(iterator& iter) {
         if(child != nullptr) {
             child->parent = nullptr;
         }
-        delete rnode;
+        allocator.release(rnode);
 
     }
     /*
@@ -477,7 +508,7 @@ void RBTree<T, K>::remove(iterator& iter) {
             parent->rightChild = child;
         }
 
-        delete rnode;
+        allocator.release(rnode);
 
     } else if(child == nullptr && rnode->color == BLACK && parent != nullptr) {
         /*
@@ -490,7 +521,7 @@ void RBTree<T, K>::remove(iterator& iter) {
             parent->rightChild = nullptr;
         }
 
-        delete rnode;
+        allocator.release(rnode);
     } else if(child->color == RED && parent != nullptr && rnode->color == BLACK) {
         /*
          * case 5.2.1: rnode is BLACK and child is RED
@@ -502,7 +533,7 @@ void RBTree<T, K>::remove(iterator& iter) {
             parent->rightChild = child;
         }
         child->parent = parent;
-        delete rnode;
+        allocator.release(rnode);
     } else {
         /*
          * case 5.2.2: rnode is BLACK and child is BLACK -> should not be possible to exist
@@ -513,13 +544,13 @@ void RBTree<T, K>::remove(iterator& iter) {
     m_size--;
 }
 
-template <typename T, typename K>
-typename RBTree<T, K>::iterator RBTree<T, K>::find(K key) {
+template <typename T, typename K, typename A>
+typename RBTree<T, K, A>::iterator RBTree<T, K, A>::find(K key) {
     RBNode<T, K>* current = root;
 
     while(current != nullptr) {
         if(current->key == key) {
-            return RBTree<T, K>::iterator(this, current);
+            return RBTree<T, K, A>::iterator(this, current);
         } else if(key < current->key) {
             current = current->leftChild;
         } else {
@@ -529,16 +560,16 @@ typename RBTree<T, K>::iterator RBTree<T, K>::find(K key) {
     return end();
 }
 
-template <typename T, typename K>
-RBNode<T, K>* RBTree<T, K>::grandparent(RBNode<T, K>* x) {
+template <typename T, typename K, typename A>
+RBNode<T, K>* RBTree<T, K, A>::grandparent(RBNode<T, K>* x) {
     if(x == nullptr || x->parent == nullptr) {
         return nullptr;
     }
     return x->parent->parent;
 }
 
-template <typename T, typename K>
-RBNode<T, K>* RBTree<T, K>::uncle(RBNode<T, K>* x) {
+template <typename T, typename K, typename A>
+RBNode<T, K>* RBTree<T, K, A>::uncle(RBNode<T, K>* x) {
     if(grandparent(x) == nullptr) {
         return nullptr;
     }
@@ -549,8 +580,8 @@ RBNode<T, K>* RBTree<T, K>::uncle(RBNode<T, K>* x) {
     }
 }
 
-template <typename T, typename K>
-RBNode<T, K>* RBTree<T, K>::sibling(RBNode<T, K>* x) {
+template <typename T, typename K, typename A>
+RBNode<T, K>* RBTree<T, K, A>::sibling(RBNode<T, K>* x) {
     if(x->parent == nullptr) {
         return nullptr;
     }
@@ -561,8 +592,8 @@ RBNode<T, K>* RBTree<T, K>::sibling(RBNode<T, K>* x) {
     }
 }
 
-template <typename T, typename K>
-RBNode<T, K>* RBTree<T, K>::findSwapNode(RBNode<T, K>* x) {
+template <typename T, typename K, typename A>
+RBNode<T, K>* RBTree<T, K, A>::findSwapNode(RBNode<T, K>* x) {
     /*
      * find node with smallest key in right subtree of x
      */
@@ -574,13 +605,13 @@ RBNode<T, K>* RBTree<T, K>::findSwapNode(RBNode<T, K>* x) {
     return node;
 }
 
-template <typename T, typename K>
-typename RBTree<T, K>::tree_size_t RBTree<T, K>::size() const {
+template <typename T, typename K, typename A>
+typename RBTree<T, K, A>::tree_size_t RBTree<T, K, A>::size() const {
     return m_size;
 }
 
-template <typename T, typename K>
-void RBTree<T, K>::rotate_right(RBNode<T, K>* x) {
+template <typename T, typename K, typename A>
+void RBTree<T, K, A>::rotate_right(RBNode<T, K>* x) {
     RBNode<T, K> *leftchild, *rightgrandchild, *parent;
 
     leftchild = x->leftChild;
@@ -609,8 +640,8 @@ void RBTree<T, K>::rotate_right(RBNode<T, K>* x) {
     }
 }
 
-template <typename T, typename K>
-void RBTree<T, K>::rotate_left(RBNode<T, K>* x) {
+template <typename T, typename K, typename A>
+void RBTree<T, K, A>::rotate_left(RBNode<T, K>* x) {
     RBNode<T, K> *rightchild, *leftgrandchild, *parent;
     rightchild = x->rightChild;
     leftgrandchild = rightchild->leftChild;
@@ -50,7 +50,7 @@
 
 namespace dsme {
 
-template <typename T, typename K>
+template <typename T, typename K, typename A>
 class RBTree;
 
 template <typename T, typename K>
@@ -58,10 +58,11 @@ struct RBNode;
 
 template <typename T, typename K>
 class RBTreeIterator {
-    friend class RBTree<T, K>;
+    template <typename, typename, typename>
+    friend class RBTree;
 
 public:
-    RBTreeIterator(const RBTree<T, K>* instance, RBNode<T, K>* initialNode);
+    RBTreeIterator(const void* instance, RBNode<T, K>* initialNode);
 
     RBTreeIterator(const RBTreeIterator&);
 
@@ -83,15 +84,18 @@ public:
     bool operator==(const RBTreeIterator<T, K>&) const;
     bool operator!=(const RBTreeIterator<T, K>&) const;
 
-    static RBTreeIterator<T, K> begin(RBTree<T, K>* instance, RBNode<T, K>* rootNode);
+    static RBTreeIterator<T, K> begin(const void* instance, RBNode<T, K>* rootNode);
 
 private:
-    const RBTree<T, K>* instance;
+    /*
+     * identifies the tree the iterator belongs to, independent of its allocator
+     */
+    const void* instance;
     RBNode<T, K>* currentNode;
 };
 
 template <typename T, typename K>
-RBTreeIterator<T, K>::RBTreeIterator(const RBTree<T, K>* instance, RBNode<T, K>* initialNode) : instance(instance), currentNode(initialNode) {
+RBTreeIterator<T, K>::RBTreeIterator(const void* instance, RBNode<T, K>* initialNode) : instance(instance), currentNode(initialNode) {
 }
 
 template <typename T, typename K>
@@ -238,7 +242,7 @@ bool RBTreeIterator<T, K>::operator!=(const RBTreeIterator<T, K>& other) const {
 
 #ifdef RBTREE_ITERATOR_POSTORDER
 template <typename T, typename K>
-RBTreeIterator<T, K> RBTreeIterator<T, K>::begin(RBTree<T, K>* instance, RBNode<T, K>* rootNode) {
+RBTreeIterator<T, K> RBTreeIterator<T, K>::begin(const void* instance, RBNode<T, K>* rootNode) {
     if(rootNode == nullptr) {
         return RBTreeIterator(instance, rootNode);
     }
@@ -258,7 +262,7 @@ RBTreeIterator<T, K> RBTreeIterator<T, K>::begin(RBTree<T, K>* instance, RBNode<
 }
 #else
 template <typename T, typename K>
-RBTreeIterator<T, K> RBTreeIterator<T, K>::begin(RBTree<T, K>* instance, RBNode<T, K>* rootNode) {
+RBTreeIterator<T, K> RBTreeIterator<T, K>::begin(const void* instance, RBNode<T, K>* rootNode) {
     return RBTreeIterator(instance, rootNode);
 }
 #endif
@@ -90,7 +90,7 @@ void DATA::request(request_parameters& params) {
     if(params.gtsTx) {
         // TODO use short address!
         IEEE802154MacAddress& dest = msg->getHeader().getDestAddr();
-        NeighborQueue<MAX_NEIGHBORS>::iterator destIt = dsme.getMessageDispatcher().getNeighborQueue().findByAddress(dest);
+        NeighborQueue::iterator destIt = dsme.getMessageDispatcher().getNeighborQueue().findByAddress(dest);
 
         DSMEAllocationCounterTable& macDSMEACT = dsme.getMAC_PIB().macDSMEACT;
         uint16_t numAllocatedSlots = macDSMEACT.getNumAllocatedGTS(dest.getShortAddress(), Direction::TX);
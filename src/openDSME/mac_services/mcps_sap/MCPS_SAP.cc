@@ -63,8 +63,8 @@ PURGE& MCPS_SAP::getPURGE() {
     return this->purge;
 }
 
-uint8_t MCPS_SAP::getMessageCount(const IEEE802154MacAddress& addr) const {
-    const NeighborQueue<MAX_NEIGHBORS>::iterator it = this->dsme.getMessageDispatcher().getNeighborQueue().findByAddress(addr);
+uint16_t MCPS_SAP::getMessageCount(const IEEE802154MacAddress& addr) const {
+    const NeighborQueue::iterator it = this->dsme.getMessageDispatcher().getNeighborQueue().findByAddress(addr);
     return this->dsme.getMessageDispatcher().getNeighborQueue().getPacketsInQueue(it);
 }
 
@@ -59,7 +59,7 @@ public:
     DATA& getDATA();
     PURGE& getPURGE();
 
-    uint8_t getMessageCount(const IEEE802154MacAddress& addr) const;
+    uint16_t getMessageCount(const IEEE802154MacAddress& addr) const;
 
 private:
     DSMELayer& dsme;
@@ -63,6 +63,7 @@ void ASSOCIATE::request(request_parameters& params) {
     // update PHY and MAC PIB attributes
     dsme.getPlatform().setChannelNumber(params.channelNumber); // TODO Move -> AssociationManager
     dsme.getPHY_PIB().phyCurrentPage = params.channelPage;
+    dsme.getMAC_PIB().helper.update();
     dsme.getMAC_PIB().macPANId = params.coordPanId;
     if(params.coordAddrMode == AddrMode::SHORT_ADDRESS) {
         dsme.getMAC_PIB().macCoordShortAddress = params.coordAddress.getShortAddress();
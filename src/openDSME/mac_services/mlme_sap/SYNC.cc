@@ -53,6 +53,7 @@ SYNC::SYNC(DSMELayer& dsme) : dsme(dsme) {
 
 void SYNC::request(request_parameters& params) {
     dsme.getPHY_PIB().phyCurrentPage = params.channelPage;
+    dsme.getMAC_PIB().helper.update();
     dsme.getPHY_PIB().phyCurrentChannel = params.channelNumber;
     dsme.getMAC_PIB().macSyncParentShortAddress = params.syncParentShortAddress;
     dsme.getMAC_PIB().macSyncParentSdIndex = params.syncParentSdIndex;
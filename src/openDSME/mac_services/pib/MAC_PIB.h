@@ -43,6 +43,7 @@
 #ifndef MAC_PIB_H_
 #define MAC_PIB_H_
 
+#include "../../../dsme_settings.h"
 #include "../DSME_Common.h"
 #include "../dataStructures/BeaconBitmap.h"
 #include "../dataStructures/DSMEAllocationCounterTable.h"
@@ -50,6 +51,7 @@
 #include "../dataStructures/IEEE802154MacAddress.h"
 #include "./PHY_PIB.h"
 #include "./PIBHelper.h"
+#include "./dsme_mac_constants.h"
 
 namespace dsme {
 
@@ -72,6 +74,56 @@ public:
     /* Indication of whether the device is a coordinator. */
     bool macIsCoord{false};
 
+    /* Capacities of the queues, read once when the DSME layer is initialized. */
+
+    /* Maximum number of neighbors messages can be queued for in GTS. */
+    uint16_t macMaxNeighbors{MAX_NEIGHBORS};
+
+    /* Time in symbols after which a neighbor without queued messages and without allocated slots is removed, 0 disables the removal. */
+    uint32_t macNeighborIdleTimeout{0};
+
+    /* Maximum number of messages waiting for transmission in the CAP. */
+    uint16_t macCAPQueueSize{CAP_QUEUE_SIZE};
+
+    /* Maximum number of messages waiting for transmission in GTS, summed over all neighbors. */
+    uint16_t macGTSQueueSize{TOTAL_GTS_QUEUE_SIZE};
+
+    /* Maximum number of messages buffered by the adaption layer for a retry. */
+    uint16_t macUpperLayerQueueSize{UPPER_LAYER_QUEUE_SIZE};
+
+    /* Delay in symbols before a message in the retry buffer of the adaption layer is resubmitted, doubled for every further retry. */
+    uint32_t macRetryBufferBackoff{aBaseSuperframeDuration};
+
+    /* Maximum number of doublings of macRetryBufferBackoff. */
+    uint8_t macRetryBufferMaxBackoffExponent{5};
+
+    /* Time in symbols after the first retry a message is dropped from the retry buffer, 0 for no limit. */
+    uint32_t macRetryBufferMaxAge{0};
+
+    /* Order each priority class of the GTS queue by deadline instead of arrival. */
+    bool macGTSQueueEDF{false};
+
+    /* Number of messages in the GTS queue every neighbor can use, the remainder is shared between all neighbors. */
+    uint16_t macGTSQueueGuaranteed{0};
+
+    /* Handling of messages for a neighbor that exhausted its quota of the GTS queue. */
+    QueueDropPolicy macGTSQueueDropPolicy{TAIL_DROP};
+
+    /* Waiting time in symbols above which the queue of a neighbor is considered standing (SOJOURN_TIME only). */
+    uint32_t macGTSQueueSojournTarget{6250};
+
+    /* Time in symbols a standing queue may persist before an arrival is dropped, and between such drops (SOJOURN_TIME only). */
+    uint32_t macGTSQueueSojournInterval{62500};
+
+    /* Send further queued frames in a TX GTS after a successful transmission as long as they fit. */
+    bool macMultipleFramesPerGTS{false};
+
+    /* Maximum size in bytes of a GTS frame packing several upper layer packets for the same neighbor, 0 disables aggregation. */
+    uint8_t macMaxAggregateSize{0};
+
+    /* Time in symbols a single queued packet may be held back in its GTS waiting for packets to aggregate with. */
+    uint32_t macAggregationDelayBudget{0};
+
     /* GENERAL PART FROM HERE ON ------------------------------------------> */
 
     /** The extended address assigned to the device. */
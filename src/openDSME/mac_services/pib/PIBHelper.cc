@@ -51,69 +51,73 @@
 
 namespace dsme {
 
-PIBHelper::PIBHelper(PHY_PIB& phy_pib, MAC_PIB& mac_pib) : phy_pib(phy_pib), mac_pib(mac_pib) {
+PIBHelper::PIBHelper(PHY_PIB& phy_pib, MAC_PIB& mac_pib)
+    : phy_pib(phy_pib),
+      mac_pib(mac_pib),
+      numberSuperframesPerMultiSuperframe(0),
+      numberSuperframesPerBeaconInterval(0),
+      numberMultiSuperframesPerBeaconInterval(0),
+      finalCAPSlot{0, 0},
+      numGTSlots{0, 0},
+      subBlockLengthBytes{0, 0},
+      symbolsPerSlot(0),
+      symbolsPerSuperframe(0),
+      symbolsPerMultiSuperframe(0),
+      ackWaitDuration(0),
+      transactionPersistenceSymbols(0),
+      channels(nullptr) {
     return;
 }
 
-uint8_t PIBHelper::getNumberSuperframesPerMultiSuperframe() const {
+void PIBHelper::update() {
     /* 2^(MO-SO) */
-    return 1 << (uint8_t)(this->mac_pib.macMultiSuperframeOrder - this->mac_pib.macSuperframeOrder);
-}
+    this->numberSuperframesPerMultiSuperframe = 1 << (uint16_t)(this->mac_pib.macMultiSuperframeOrder - this->mac_pib.macSuperframeOrder);
 
-unsigned PIBHelper::getNumberSuperframesPerBeaconInterval() const {
     /* 2^(BO-SO) */
-    return 1 << (unsigned)(this->mac_pib.macBeaconOrder - this->mac_pib.macSuperframeOrder);
-}
+    this->numberSuperframesPerBeaconInterval = 1 << (unsigned)(this->mac_pib.macBeaconOrder - this->mac_pib.macSuperframeOrder);
 
-unsigned PIBHelper::getNumberMultiSuperframesPerBeaconInterval() const {
     /*  2^(BO-MO) */
-    return 1 << (unsigned)(this->mac_pib.macBeaconOrder - this->mac_pib.macMultiSuperframeOrder);
-}
-
-uint8_t PIBHelper::getFinalCAPSlot(uint8_t superframeId) const {
-    if((mac_pib.macCapReduction == false) || (superframeId == 0)) { // correct?
-        return 8;
-    } else {
-        return 0;
-    }
-}
+    this->numberMultiSuperframesPerBeaconInterval = 1 << (unsigned)(this->mac_pib.macBeaconOrder - this->mac_pib.macMultiSuperframeOrder);
 
-uint32_t PIBHelper::getSymbolsPerSlot() const {
     /* aBaseSlotDuration * 2^(SO) */
-    return aBaseSlotDuration * (1 << (uint32_t) this->mac_pib.macSuperframeOrder);
-}
+    this->symbolsPerSlot = aBaseSlotDuration * (1 << (uint32_t) this->mac_pib.macSuperframeOrder);
+    this->symbolsPerSuperframe = aNumSuperframeSlots * this->symbolsPerSlot;
+    this->symbolsPerMultiSuperframe = aNumSuperframeSlots * (uint32_t)aBaseSlotDuration * (1 << (uint32_t) this->mac_pib.macMultiSuperframeOrder);
 
-uint8_t PIBHelper::getNumGTSlots(uint8_t superframeId) const {
-    return (aNumSuperframeSlots - 1 - getFinalCAPSlot(superframeId));
-}
-
-uint8_t PIBHelper::getNumChannels() const {
+    this->channels = nullptr;
     for(uint8_t i = 0; i < phy_pib.phyChannelsSupported.getLength(); i++) {
-        if(phy_pib.phyChannelsSupported[i]->key == phy_pib.phyCurrentPage) {
-            return phy_pib.phyChannelsSupported[i]->value.getLength();
+        if(phy_pib.phyChannelsSupported[i] != nullptr && phy_pib.phyChannelsSupported[i]->key == phy_pib.phyCurrentPage) {
+            this->channels = &(phy_pib.phyChannelsSupported[i]->value);
+            break;
         }
     }
-    DSME_ASSERT(false);
-    return 0;
-}
+    DSME_ASSERT(this->channels != nullptr);
 
-const channelList_t& PIBHelper::getChannels() const {
-    static channelList_t emptyList(0);
-
-    for(uint8_t i = 0; i < phy_pib.phyChannelsSupported.getLength(); i++) {
-        if(phy_pib.phyChannelsSupported[i]->key == phy_pib.phyCurrentPage) {
-            return phy_pib.phyChannelsSupported[i]->value;
+    for(uint8_t i = 0; i < 2; i++) {
+        if((mac_pib.macCapReduction == false) || (i == 0)) { // correct?
+            this->finalCAPSlot[i] = 8;
+        } else {
+            this->finalCAPSlot[i] = 0;
         }
+        this->numGTSlots[i] = aNumSuperframeSlots - 1 - this->finalCAPSlot[i];
+        this->subBlockLengthBytes[i] = (this->numGTSlots[i] * this->channels->getLength() - 1) / 8 + 1;
     }
-    return emptyList;
-}
 
-uint8_t PIBHelper::getSubBlockLengthBytes(uint8_t superframeId) const {
-    return (getNumGTSlots(superframeId) * getNumChannels() - 1) / 8 + 1;
+    /* unit period is aBaseSuperframeDuration * 2^(BO), or aBaseSuperframeDuration for BO = 15 */
+    uint64_t unitPeriod = aBaseSuperframeDuration * (this->mac_pib.macBeaconOrder < 15 ? (1 << (uint32_t) this->mac_pib.macBeaconOrder) : 1);
+    uint64_t persistence = unitPeriod * this->mac_pib.macTransactionPersistenceTime;
+    this->transactionPersistenceSymbols = (persistence < INT32_MAX) ? persistence : INT32_MAX;
+
+    this->ackWaitDuration = aUnitBackoffPeriod + aTurnaroundTime + phy_pib.phySHRDuration + 6 * phy_pib.phySymbolsPerOctet + ADDITIONAL_ACK_WAIT_DURATION;
 }
 
-uint16_t PIBHelper::getAckWaitDuration() const {
-    return aUnitBackoffPeriod + aTurnaroundTime + phy_pib.phySHRDuration + 6 * phy_pib.phySymbolsPerOctet + ADDITIONAL_ACK_WAIT_DURATION;
+const channelList_t& PIBHelper::getChannels() const {
+    static channelList_t emptyList(0);
+
+    if(this->channels == nullptr) {
+        return emptyList;
+    }
+    return *(this->channels);
 }
 
 } /* namespace dsme */
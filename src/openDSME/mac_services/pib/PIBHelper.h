@@ -50,35 +50,93 @@ namespace dsme {
 class MAC_PIB;
 class PHY_PIB;
 
+/*
+ * Provides the values derived from the MAC and PHY PIB.
+ * They are cached and only recomputed by update(), which has to be called whenever
+ * macSuperframeOrder, macMultiSuperframeOrder, macBeaconOrder, macCapReduction,
+ * macTransactionPersistenceTime, phyChannelsSupported or phyCurrentPage are changed.
+ */
 class PIBHelper {
 public:
     PIBHelper(PHY_PIB&, MAC_PIB&);
 
+    /*
+     * Recomputes all derived values from the current PIB attributes
+     */
+    void update();
+
     /* Access to MAC_PIB variable dependent attributes */
 
-    uint8_t getNumberSuperframesPerMultiSuperframe() const;
+    uint16_t getNumberSuperframesPerMultiSuperframe() const {
+        return numberSuperframesPerMultiSuperframe;
+    }
+
+    unsigned getNumberSuperframesPerBeaconInterval() const {
+        return numberSuperframesPerBeaconInterval;
+    }
 
-    unsigned getNumberSuperframesPerBeaconInterval() const;
+    unsigned getNumberMultiSuperframesPerBeaconInterval() const {
+        return numberMultiSuperframesPerBeaconInterval;
+    }
 
-    unsigned getNumberMultiSuperframesPerBeaconInterval() const;
+    uint8_t getFinalCAPSlot(uint8_t superframeId) const {
+        return finalCAPSlot[superframeId == 0 ? 0 : 1];
+    }
 
-    uint8_t getFinalCAPSlot(uint8_t superframeId) const;
+    uint32_t getSymbolsPerSlot() const {
+        return symbolsPerSlot;
+    }
 
-    uint32_t getSymbolsPerSlot() const;
+    uint32_t getSymbolsPerSuperframe() const {
+        return symbolsPerSuperframe;
+    }
 
-    uint8_t getNumGTSlots(uint8_t superframeId) const;
+    uint32_t getSymbolsPerMultiSuperframe() const {
+        return symbolsPerMultiSuperframe;
+    }
 
-    uint8_t getNumChannels() const;
+    uint8_t getNumGTSlots(uint8_t superframeId) const {
+        return numGTSlots[superframeId == 0 ? 0 : 1];
+    }
+
+    uint8_t getNumChannels() const {
+        return channels->getLength();
+    }
 
     const channelList_t& getChannels() const;
 
-    uint8_t getSubBlockLengthBytes(uint8_t superframeID) const;
+    uint8_t getSubBlockLengthBytes(uint8_t superframeId) const {
+        return subBlockLengthBytes[superframeId == 0 ? 0 : 1];
+    }
+
+    uint16_t getAckWaitDuration() const {
+        return ackWaitDuration;
+    }
 
-    uint16_t getAckWaitDuration() const;
+    /* macTransactionPersistenceTime in symbols, limited to the range that survives the wrap of the symbol counter */
+    uint32_t getTransactionPersistenceSymbols() const {
+        return transactionPersistenceSymbols;
+    }
 
 private:
     PHY_PIB& phy_pib;
     MAC_PIB& mac_pib;
+
+    /* '-> the values for the first superframe of a multi-superframe are stored at index 0, all others at index 1 */
+    uint16_t numberSuperframesPerMultiSuperframe;
+    unsigned numberSuperframesPerBeaconInterval;
+    unsigned numberMultiSuperframesPerBeaconInterval;
+    uint8_t finalCAPSlot[2];
+    uint8_t numGTSlots[2];
+    uint8_t subBlockLengthBytes[2];
+    uint32_t symbolsPerSlot;
+    uint32_t symbolsPerSuperframe;
+    uint32_t symbolsPerMultiSuperframe;
+    uint16_t ackWaitDuration;
+    uint32_t transactionPersistenceSymbols;
+
+    /* channel list of the current page, only nullptr before the first update() */
+    const channelList_t* channels;
 };
 
 } /* namespace dsme */